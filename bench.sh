@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# benchmark dataflow and alias analyses on a generated function with thousands
+# of temporaries
+# usage: bench.sh [statements] [rounds]
+
+STATEMENTS=${1:-1000}
+ROUNDS=${2:-10}
+BENCH_DIR=./build/bench
+BENCH_SPL=$BENCH_DIR/bench.spl
+
+mkdir -p $BENCH_DIR
+make splc BUILD_DIR=$BENCH_DIR BINARY_DIR=$BENCH_DIR \
+    CPPFLAGS="-O2 -I./src -I$BENCH_DIR -std=c++17 -DSPL_IR_ANALYSIS_BENCHMARK=$ROUNDS" \
+    > /dev/null || exit 1
+
+# every statement produces four temporaries, every third statement is
+# followed by accesses to an array at constant and variable indices, every
+# fourth statement is followed by a branch
+{
+    echo "int bench(int x)"
+    echo "{"
+    echo "    int a0 = x;"
+    echo "    int a1 = x + 1;"
+    echo "    int m[16];"
+    for ((i = 2; i < STATEMENTS; i++)); do
+        echo "    int a$i;"
+    done
+    echo "    while (a0 < 100) {"
+    for ((i = 2; i < STATEMENTS; i++)); do
+        echo "        a$i = (a$((i - 1)) + x) * $((i % 7 + 2)) - a$((i - 2)) / $((i % 5 + 1));"
+        if ((i % 3 == 0)); then
+            echo "        m[$((i % 16))] = a$i + m[x];"
+            echo "        m[x + $((i % 4))] = m[$(((i + 5) % 16))];"
+        fi
+        if ((i % 4 == 0)); then
+            echo "        if (a$i > 1000) a$i = a$i - 1000;"
+        fi
+    done
+    echo "        a0 = a0 + a$((STATEMENTS - 1)) - a$((STATEMENTS - 2)) + 1;"
+    echo "    }"
+    echo "    return a$((STATEMENTS - 1));"
+    echo "}"
+    echo "int main()"
+    echo "{"
+    echo "    write(bench(read()));"
+    echo "    return 0;"
+    echo "}"
+} > $BENCH_SPL
+
+echo "apply splc on $BENCH_SPL ($STATEMENTS statements, $ROUNDS rounds)"
+$BENCH_DIR/splc $BENCH_SPL > /dev/null
+exit 0
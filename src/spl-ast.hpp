@@ -2,6 +2,7 @@
 #define SPL_AST_HPP
 
 #include "spl-ir.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <forward_list>
@@ -73,6 +74,9 @@ struct IrVarDesc {
     bool is_addr = false;
     std::forward_list<std::shared_ptr<Patchable>> truelist, falselist;
     std::shared_ptr<SplIrLabelInstruction> label;
+    // name of the struct array split into one array per field if this is
+    // Exp -> ID of it
+    std::string split_array;
 };
 
 struct SplValExp : public SplVal {
@@ -332,29 +336,73 @@ class SplVariableSymbol : public SplSymbol {
 };
 
 class SplStructSymbol : public SplSymbol {
-    std::unordered_map<std::string, int> offsets;
-
   public:
     int install_symbol(std::shared_ptr<SplVariableSymbol> sym) {
         int res = members.install_symbol(sym);
         if (res == SplSymbolTable::SPL_SYM_INSTALL_OK) {
-            offsets[sym->name] = size;
+            fields.push_back(sym);
             size += sym->var_type->size;
         }
         return res;
     }
 
     SplSymbolTable members;
+    // members in order of declaration
+    std::vector<std::shared_ptr<SplVariableSymbol>> fields;
+    // static count of Exp DOT ID accessing each member
+    std::unordered_map<std::string, int> access_counts;
     SplStructSymbol(const std::string &name)
         : SplSymbol{name, SplSymbolType::SPL_SYM_STRUCT} {}
+    // raw size in order of declaration, the layout in memory is decided by
+    // SplStructLayout
     int size = 0;
-    int get_offset(const std::string &name) { return offsets[name]; }
     void print() {
         std::cout << "Struct: " << name << std::endl;
         members.print();
     }
 };
 
+// memory is accessed a word at a time, so every scalar takes a word of its own
+constexpr int SPL_WORD_SIZE = 4;
+
+// offsets of the fields of a struct in memory
+class SplStructLayout {
+  public:
+    struct SplFieldInfo {
+        std::string name;
+        int size, access_count;
+    };
+
+    std::unordered_map<std::string, int> offsets;
+    int size = 0;
+
+    SplStructLayout() = default;
+    // fields are laid out one after another in order of declaration; once
+    // reordered, fields never accessed are dropped and the others go by
+    // decreasing access count, so that the hottest field is at offset 0
+    SplStructLayout(std::vector<SplFieldInfo> fields, bool reorder) {
+        if (reorder) {
+            fields.erase(std::remove_if(fields.begin(), fields.end(),
+                                        [](const SplFieldInfo &field) {
+                                            return field.access_count == 0;
+                                        }),
+                         fields.end());
+            std::stable_sort(fields.begin(), fields.end(),
+                             [](const SplFieldInfo &a, const SplFieldInfo &b) {
+                                 return a.access_count > b.access_count;
+                             });
+        }
+        for (auto &field : fields) {
+            offsets[field.name] = size;
+            size += field.size;
+        }
+        // instances of a struct without fields still have an address
+        if (size == 0) {
+            size = SPL_WORD_SIZE;
+        }
+    }
+};
+
 class SplFunctionSymbol : public SplSymbol {
   public:
     // notice that spl does not support array return type
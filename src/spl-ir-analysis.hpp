@@ -0,0 +1,1883 @@
+#ifndef SPL_IR_ANALYSIS_HPP
+#define SPL_IR_ANALYSIS_HPP
+
+#include "spl-ir.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// analyses cached by SplIrAnalysisManager, they are used as bit flags so that
+// a pass is able to declare which analyses it breaks
+enum SplIrAnalysisType : unsigned {
+    SPL_IR_ANALYSIS_REVERSE_POST_ORDER = 1u << 0,
+    SPL_IR_ANALYSIS_DOMINATOR_TREE = 1u << 1,
+    SPL_IR_ANALYSIS_NATURAL_LOOPS = 1u << 2,
+    SPL_IR_ANALYSIS_LIVENESS = 1u << 3,
+    SPL_IR_ANALYSIS_REACHING_DEFINITIONS = 1u << 4,
+    SPL_IR_ANALYSIS_AVAILABLE_EXPRESSIONS = 1u << 5,
+    SPL_IR_ANALYSIS_CALL_GRAPH = 1u << 6,
+    SPL_IR_ANALYSIS_FUNCTION_SUMMARIES = 1u << 7,
+    SPL_IR_ANALYSIS_ALIAS = 1u << 8,
+};
+
+using SplIrAnalysisSet = unsigned;
+
+constexpr SplIrAnalysisSet SPL_IR_ANALYSIS_NONE = 0;
+// analyses depending on nothing but the control flow graph
+constexpr SplIrAnalysisSet SPL_IR_ANALYSIS_CONTROL_FLOW =
+    SPL_IR_ANALYSIS_REVERSE_POST_ORDER | SPL_IR_ANALYSIS_DOMINATOR_TREE |
+    SPL_IR_ANALYSIS_NATURAL_LOOPS;
+// analyses depending on operands of instructions as well
+constexpr SplIrAnalysisSet SPL_IR_ANALYSIS_DATAFLOW =
+    SPL_IR_ANALYSIS_LIVENESS | SPL_IR_ANALYSIS_REACHING_DEFINITIONS |
+    SPL_IR_ANALYSIS_AVAILABLE_EXPRESSIONS | SPL_IR_ANALYSIS_CALL_GRAPH |
+    SPL_IR_ANALYSIS_FUNCTION_SUMMARIES | SPL_IR_ANALYSIS_ALIAS;
+constexpr SplIrAnalysisSet SPL_IR_ANALYSIS_ALL = ~0u;
+
+using SplIrBasicBlockVector = std::vector<std::shared_ptr<SplIrBasicBlock>>;
+using SplIrOperandSet = std::unordered_set<std::shared_ptr<SplIrOperand>>;
+
+class SplIrFunction {
+  public:
+    std::string name;
+    // basic blocks in program order, the first one is the entry
+    SplIrBasicBlockVector basic_blocks;
+    std::unordered_set<SplIrBasicBlock *> members;
+
+    bool contains(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        return members.count(basic_block.get()) > 0;
+    }
+};
+
+class SplIrReversePostOrder {
+  public:
+    // basic blocks unreachable from the entry are left out
+    SplIrBasicBlockVector order;
+    std::unordered_map<SplIrBasicBlock *, size_t> index;
+
+    bool
+    is_reachable(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        return index.count(basic_block.get()) > 0;
+    }
+};
+
+// dense bit set, set operations work on a whole word (two words with sse2) at
+// a time
+class SplIrBitVector {
+  private:
+    std::vector<uint64_t> words;
+    size_t width = 0;
+
+    void clear_padding() {
+        if (width % 64 != 0) {
+            words.back() &= (uint64_t(1) << (width % 64)) - 1;
+        }
+    }
+
+  public:
+    SplIrBitVector() = default;
+    explicit SplIrBitVector(size_t width, bool value = false)
+        : words((width + 63) / 64, value ? ~uint64_t(0) : 0), width(width) {
+        clear_padding();
+    }
+
+    size_t size() const { return width; }
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void set(size_t i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+    void reset(size_t i) { words[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+    void set_all() {
+        std::fill(words.begin(), words.end(), ~uint64_t(0));
+        clear_padding();
+    }
+    void reset_all() { std::fill(words.begin(), words.end(), 0); }
+
+    // the following two return whether this bit vector is changed
+    bool union_with(const SplIrBitVector &rhs) {
+        size_t i = 0;
+        bool changed = false;
+#if defined(__SSE2__)
+        for (; i + 2 <= words.size(); i += 2) {
+            auto *p = reinterpret_cast<__m128i *>(&words[i]);
+            auto lhs = _mm_loadu_si128(p);
+            auto res = _mm_or_si128(
+                lhs, _mm_loadu_si128(
+                         reinterpret_cast<const __m128i *>(&rhs.words[i])));
+            changed |= _mm_movemask_epi8(_mm_cmpeq_epi8(lhs, res)) != 0xffff;
+            _mm_storeu_si128(p, res);
+        }
+#endif
+        for (; i < words.size(); i++) {
+            auto res = words[i] | rhs.words[i];
+            changed |= res != words[i];
+            words[i] = res;
+        }
+        return changed;
+    }
+    bool intersect_with(const SplIrBitVector &rhs) {
+        size_t i = 0;
+        bool changed = false;
+#if defined(__SSE2__)
+        for (; i + 2 <= words.size(); i += 2) {
+            auto *p = reinterpret_cast<__m128i *>(&words[i]);
+            auto lhs = _mm_loadu_si128(p);
+            auto res = _mm_and_si128(
+                lhs, _mm_loadu_si128(
+                         reinterpret_cast<const __m128i *>(&rhs.words[i])));
+            changed |= _mm_movemask_epi8(_mm_cmpeq_epi8(lhs, res)) != 0xffff;
+            _mm_storeu_si128(p, res);
+        }
+#endif
+        for (; i < words.size(); i++) {
+            auto res = words[i] & rhs.words[i];
+            changed |= res != words[i];
+            words[i] = res;
+        }
+        return changed;
+    }
+    void subtract(const SplIrBitVector &rhs) {
+        for (size_t i = 0; i < words.size(); i++) {
+            words[i] &= ~rhs.words[i];
+        }
+    }
+
+    bool operator==(const SplIrBitVector &rhs) const {
+        return width == rhs.width && words == rhs.words;
+    }
+    bool operator!=(const SplIrBitVector &rhs) const { return !(*this == rhs); }
+    bool any() const {
+        for (auto word : words) {
+            if (word != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    size_t count() const {
+        size_t result = 0;
+        for (auto word : words) {
+            result += __builtin_popcountll(word);
+        }
+        return result;
+    }
+    // visit set bits in ascending order
+    template <typename F> void for_each(F f) const {
+        for (size_t i = 0; i < words.size(); i++) {
+            for (auto word = words[i]; word != 0; word &= word - 1) {
+                f(i * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+};
+
+// maps operands of a function to dense ids used as bit vector indices
+class SplIrOperandNumbering {
+  public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    std::vector<std::shared_ptr<SplIrOperand>> operands;
+    std::unordered_map<SplIrOperand *, size_t> index;
+
+    size_t size() const { return operands.size(); }
+    size_t add(const std::shared_ptr<SplIrOperand> &op) {
+        auto it = index.find(op.get());
+        if (it != index.end()) {
+            return it->second;
+        }
+        index[op.get()] = operands.size();
+        operands.push_back(op);
+        return operands.size() - 1;
+    }
+    size_t find(const std::shared_ptr<SplIrOperand> &op) const {
+        auto it = index.find(op.get());
+        return it == index.end() ? npos : it->second;
+    }
+};
+
+enum class SplIrDataflowDirection { FORWARD, BACKWARD };
+
+enum class SplIrDataflowMeet { UNION, INTERSECTION };
+
+// a gen/kill problem over basic blocks reachable from the entry, the transfer
+// function of a basic block is out = gen | (in & ~kill), with in and out
+// swapped for backward problems
+class SplIrDataflowProblem {
+  public:
+    SplIrDataflowDirection direction;
+    SplIrDataflowMeet meet;
+    size_t width;
+    // indexed in reverse post order
+    std::vector<SplIrBitVector> gen, kill;
+    // flows into the entry for forward problems, out of the exits for
+    // backward problems
+    SplIrBitVector boundary;
+
+    SplIrDataflowProblem(SplIrDataflowDirection direction,
+                         SplIrDataflowMeet meet, size_t width,
+                         size_t basic_block_count)
+        : direction(direction), meet(meet), width(width),
+          gen(basic_block_count, SplIrBitVector(width)),
+          kill(basic_block_count, SplIrBitVector(width)), boundary(width) {}
+};
+
+class SplIrDataflowResult {
+  public:
+    // indexed in reverse post order
+    std::vector<SplIrBitVector> in, out;
+};
+
+void solve_dataflow(const SplIrFunction &function,
+                    const SplIrReversePostOrder &rpo,
+                    const SplIrDataflowProblem &problem,
+                    SplIrDataflowResult &result);
+
+class SplIrDominatorTree {
+  public:
+    // the entry is mapped to nullptr
+    std::unordered_map<SplIrBasicBlock *, std::shared_ptr<SplIrBasicBlock>>
+        idom;
+    std::unordered_map<SplIrBasicBlock *, SplIrBasicBlockVector> children;
+    // preorder and postorder numbers in the dominator tree, used to answer
+    // dominance queries in constant time
+    std::unordered_map<SplIrBasicBlock *, std::pair<int, int>> interval;
+    // basic blocks where the dominance of a basic block ends, that is where
+    // phi instructions for its definitions go
+    std::unordered_map<SplIrBasicBlock *, SplIrBasicBlockVector> frontier;
+
+    bool dominates(const std::shared_ptr<SplIrBasicBlock> &a,
+                   const std::shared_ptr<SplIrBasicBlock> &b) const {
+        auto it_a = interval.find(a.get()), it_b = interval.find(b.get());
+        if (it_a == interval.end() || it_b == interval.end()) {
+            return false;
+        }
+        return it_a->second.first <= it_b->second.first &&
+               it_b->second.second <= it_a->second.second;
+    }
+    std::shared_ptr<SplIrBasicBlock>
+    get_idom(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        auto it = idom.find(basic_block.get());
+        return it == idom.end() ? nullptr : it->second;
+    }
+    const SplIrBasicBlockVector &
+    get_children(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        static const SplIrBasicBlockVector empty;
+        auto it = children.find(basic_block.get());
+        return it == children.end() ? empty : it->second;
+    }
+    const SplIrBasicBlockVector &
+    get_frontier(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        static const SplIrBasicBlockVector empty;
+        auto it = frontier.find(basic_block.get());
+        return it == frontier.end() ? empty : it->second;
+    }
+};
+
+class SplIrLoop {
+  public:
+    std::shared_ptr<SplIrBasicBlock> header;
+    // sources of back edges to the header
+    SplIrBasicBlockVector latches;
+    // basic blocks of the loop in program order, header included
+    SplIrBasicBlockVector basic_blocks;
+    std::unordered_set<SplIrBasicBlock *> members;
+    SplIrLoop *parent = nullptr;
+    int depth = 1;
+
+    bool contains(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        return members.count(basic_block.get()) > 0;
+    }
+};
+
+class SplIrLoopInfo {
+  public:
+    // inner loops come before outer loops
+    std::vector<std::shared_ptr<SplIrLoop>> loops;
+    std::unordered_map<SplIrBasicBlock *, SplIrLoop *> innermost;
+
+    SplIrLoop *
+    get_loop(const std::shared_ptr<SplIrBasicBlock> &basic_block) const {
+        auto it = innermost.find(basic_block.get());
+        return it == innermost.end() ? nullptr : it->second;
+    }
+};
+
+class SplIrLiveness {
+  public:
+    // l-value operands of the function
+    SplIrOperandNumbering numbering;
+    std::unordered_map<SplIrBasicBlock *, SplIrBitVector> live_in, live_out;
+
+    bool is_live_in(const std::shared_ptr<SplIrBasicBlock> &basic_block,
+                    const std::shared_ptr<SplIrOperand> &op) const {
+        return test(live_in, basic_block, op);
+    }
+    bool is_live_out(const std::shared_ptr<SplIrBasicBlock> &basic_block,
+                     const std::shared_ptr<SplIrOperand> &op) const {
+        return test(live_out, basic_block, op);
+    }
+
+  private:
+    bool test(const std::unordered_map<SplIrBasicBlock *, SplIrBitVector> &sets,
+              const std::shared_ptr<SplIrBasicBlock> &basic_block,
+              const std::shared_ptr<SplIrOperand> &op) const {
+        auto it = sets.find(basic_block.get());
+        auto id = numbering.find(op);
+        return it != sets.end() && id != SplIrOperandNumbering::npos &&
+               it->second.test(id);
+    }
+};
+
+class SplIrReachingDefinitions {
+  public:
+    // instructions defining an operand
+    std::vector<std::shared_ptr<SplIrInstruction>> definitions;
+    std::unordered_map<SplIrInstruction *, size_t> index;
+    // all definitions of each operand
+    std::unordered_map<SplIrOperand *, SplIrBitVector> definitions_of;
+    std::unordered_map<SplIrBasicBlock *, SplIrBitVector> reach_in, reach_out;
+};
+
+class SplIrAvailableExpressions {
+  public:
+    // binary arithmetic expressions, keyed by their printed form
+    std::vector<std::string> expressions;
+    std::unordered_map<std::string, size_t> index;
+    std::unordered_map<SplIrBasicBlock *, SplIrBitVector> avail_in, avail_out;
+
+    // empty for instructions not computing a binary expression
+    static std::string
+    get_expression_key(const std::shared_ptr<SplIrInstruction> &inst);
+};
+
+// functions and the calls among them, built from the instruction list alone
+// so that it does not depend on basic blocks
+class SplIrCallGraph {
+  private:
+    // state of tarjan's algorithm
+    std::unordered_map<std::string, size_t> index, low_link;
+    std::vector<std::string> stack;
+    std::unordered_set<std::string> on_stack;
+
+    void find_components(const std::string &func_name);
+
+  public:
+    // function names in program order
+    std::vector<std::string> functions;
+    // callees of each function in order of their first call
+    std::unordered_map<std::string, std::vector<std::string>> callees;
+    // number of call sites calling each function
+    std::unordered_map<std::string, int> call_counts;
+    // strongly connected components, callees come before their callers
+    std::vector<std::vector<std::string>> components;
+    std::unordered_map<std::string, size_t> component_index;
+    std::unordered_set<std::string> recursive;
+
+    explicit SplIrCallGraph(const SplIrModule &ir_module);
+
+    bool is_recursive(const std::string &func_name) const {
+        return recursive.count(func_name) > 0;
+    }
+    int get_call_count(const std::string &func_name) const {
+        auto it = call_counts.find(func_name);
+        return it == call_counts.end() ? 0 : it->second;
+    }
+    bool is_defined(const std::string &func_name) const {
+        return callees.count(func_name) > 0;
+    }
+    // functions which may be called, directly or not, by the given one,
+    // itself included
+    std::unordered_set<std::string>
+    get_reachable(const std::string &func_name) const;
+};
+
+// side effects of a function, those of its callees included; memory declared
+// by the function itself does not count, as nothing else sees it
+class SplIrFunctionSummary {
+  public:
+    // memory reachable from the parameters, or from anywhere else
+    bool reads_memory = false, writes_memory = false;
+    // READ or WRITE is executed
+    bool performs_io = false;
+
+    // the result depends on the arguments alone
+    bool is_pure() const {
+        return !reads_memory && !writes_memory && !performs_io;
+    }
+    // a call whose result is unused is useless, loops without side effects
+    // are taken to terminate, as in c
+    bool is_side_effect_free() const { return !writes_memory && !performs_io; }
+};
+
+class SplIrFunctionSummaries {
+  public:
+    std::unordered_map<std::string, SplIrFunctionSummary> summaries;
+
+    // functions defined nowhere may do anything
+    SplIrFunctionSummary get_summary(const std::string &func_name) const {
+        auto it = summaries.find(func_name);
+        if (it != summaries.end()) {
+            return it->second;
+        }
+        SplIrFunctionSummary summary;
+        summary.reads_memory = summary.writes_memory = summary.performs_io =
+            true;
+        return summary;
+    }
+};
+
+// an address as a base and an offset from it, the offset is a constant plus
+// the value of an operand added to the base, if any
+class SplIrAddress {
+  public:
+    enum Kind {
+        // not known yet
+        UNDEFINED,
+        // into the memory of a declared variable
+        MEMORY,
+        // relative to a pointer value the function does not compute itself
+        POINTER,
+        // anywhere
+        UNKNOWN
+    };
+    Kind kind = UNDEFINED;
+    // numbered by SplIrAliasAnalysis
+    size_t base = 0;
+    bool offset_known = true;
+    SplIrOperand *symbol = nullptr;
+    int offset = 0;
+
+    bool operator==(const SplIrAddress &rhs) const {
+        return kind == rhs.kind && base == rhs.base &&
+               offset_known == rhs.offset_known && symbol == rhs.symbol &&
+               offset == rhs.offset;
+    }
+    bool operator!=(const SplIrAddress &rhs) const { return !(*this == rhs); }
+};
+
+// addresses computed by a function in ssa form traced back to a declared
+// memory or a pointer value, values defined outside ssa form may point
+// anywhere; like ssa values themselves, the relations between addresses hold
+// within the same iteration of every loop, as within a basic block
+class SplIrAliasAnalysis {
+  public:
+    // declared memory and pointer values by name, constants are relative to
+    // the base "#"
+    std::vector<std::string> bases;
+    std::unordered_map<std::string, size_t> base_index;
+    // declared memory whose address may be known outside the function
+    std::vector<bool> escaped;
+    // ssa values and constants used by the function
+    std::unordered_map<SplIrOperand *, SplIrAddress> addresses;
+    // a variable not declared as memory is accessed both directly and
+    // through its address
+    bool variable_address_taken = false;
+
+    SplIrAddress get_address(const std::shared_ptr<SplIrOperand> &op) const {
+        auto it = addresses.find(op.get());
+        if (it == addresses.end()) {
+            SplIrAddress address;
+            address.kind = SplIrAddress::UNKNOWN;
+            return address;
+        }
+        return it->second;
+    }
+    bool is_private(const SplIrAddress &address) const {
+        return address.kind == SplIrAddress::MEMORY && !escaped[address.base];
+    }
+    bool must_alias(const SplIrAddress &lhs, const SplIrAddress &rhs) const {
+        return (lhs.kind == SplIrAddress::MEMORY ||
+                lhs.kind == SplIrAddress::POINTER) &&
+               lhs.kind == rhs.kind && lhs.base == rhs.base &&
+               lhs.offset_known && rhs.offset_known &&
+               lhs.symbol == rhs.symbol && lhs.offset == rhs.offset;
+    }
+    // memory is accessed a word at a time
+    bool may_alias(const SplIrAddress &lhs, const SplIrAddress &rhs) const {
+        if (lhs.kind == SplIrAddress::MEMORY &&
+            rhs.kind == SplIrAddress::MEMORY && lhs.base != rhs.base) {
+            return false;
+        }
+        if ((lhs.kind == SplIrAddress::MEMORY) !=
+            (rhs.kind == SplIrAddress::MEMORY)) {
+            return !is_private(lhs) && !is_private(rhs);
+        }
+        if (lhs.kind == SplIrAddress::UNKNOWN || lhs.kind != rhs.kind ||
+            lhs.base != rhs.base ||
+            !lhs.offset_known || !rhs.offset_known ||
+            lhs.symbol != rhs.symbol) {
+            return true;
+        }
+        return std::abs(int64_t(lhs.offset) - rhs.offset) < 4;
+    }
+    // an ssa value is the same address wherever it is used
+    bool must_alias(const std::shared_ptr<SplIrOperand> &lhs,
+                    const std::shared_ptr<SplIrOperand> &rhs) const {
+        return (lhs == rhs && addresses.count(lhs.get()) > 0) ||
+               must_alias(get_address(lhs), get_address(rhs));
+    }
+    bool may_alias(const std::shared_ptr<SplIrOperand> &lhs,
+                   const std::shared_ptr<SplIrOperand> &rhs) const {
+        return may_alias(get_address(lhs), get_address(rhs));
+    }
+};
+
+class SplIrAnalysisManager {
+  private:
+    struct SplIrFunctionAnalyses {
+        SplIrAnalysisSet valid = SPL_IR_ANALYSIS_NONE;
+        SplIrReversePostOrder reverse_post_order;
+        SplIrDominatorTree dominator_tree;
+        SplIrLoopInfo natural_loops;
+        SplIrLiveness liveness;
+        SplIrReachingDefinitions reaching_definitions;
+        SplIrAvailableExpressions available_expressions;
+        SplIrAliasAnalysis alias_analysis;
+    };
+
+    SplIrModule &ir_module;
+    unsigned long basic_blocks_version;
+    bool functions_built = false;
+    std::vector<std::shared_ptr<SplIrFunction>> functions;
+    std::unordered_map<std::string, std::shared_ptr<SplIrFunction>>
+        func_name_2_function;
+    std::unordered_map<std::string, SplIrFunctionAnalyses> cache;
+    // the call graph belongs to the whole module
+    std::shared_ptr<SplIrCallGraph> call_graph;
+    std::shared_ptr<SplIrFunctionSummaries> function_summaries;
+
+    void sync();
+    SplIrFunctionAnalyses &get_cache(const std::string &func_name,
+                                     SplIrAnalysisType type);
+
+    void compute_reverse_post_order(const SplIrFunction &function,
+                                    SplIrReversePostOrder &result);
+    void compute_dominator_tree(const SplIrReversePostOrder &rpo,
+                                SplIrDominatorTree &result);
+    void compute_natural_loops(const SplIrFunction &function,
+                               const SplIrReversePostOrder &rpo,
+                               const SplIrDominatorTree &dom,
+                               SplIrLoopInfo &result);
+    void compute_liveness(const SplIrFunction &function,
+                          const SplIrReversePostOrder &rpo,
+                          SplIrLiveness &result);
+    void compute_reaching_definitions(const SplIrFunction &function,
+                                      const SplIrReversePostOrder &rpo,
+                                      SplIrReachingDefinitions &result);
+    void compute_available_expressions(const SplIrFunction &function,
+                                       const SplIrReversePostOrder &rpo,
+                                       SplIrAvailableExpressions &result);
+    void compute_alias_analysis(const SplIrFunction &function,
+                                SplIrAliasAnalysis &result);
+    void compute_function_summaries(const SplIrCallGraph &call_graph,
+                                    SplIrFunctionSummaries &result);
+
+  public:
+    // how many analyses are computed and reused, for debug
+    int computed_count = 0, reused_count = 0;
+
+    explicit SplIrAnalysisManager(SplIrModule &ir_module)
+        : ir_module(ir_module),
+          basic_blocks_version(ir_module.basic_blocks_version) {}
+
+    const std::vector<std::shared_ptr<SplIrFunction>> &get_functions();
+    std::shared_ptr<SplIrFunction> get_function(const std::string &func_name);
+
+    const SplIrReversePostOrder &
+    get_reverse_post_order(const std::string &func_name);
+    const SplIrDominatorTree &get_dominator_tree(const std::string &func_name);
+    const SplIrLoopInfo &get_natural_loops(const std::string &func_name);
+    const SplIrLiveness &get_liveness(const std::string &func_name);
+    const SplIrReachingDefinitions &
+    get_reaching_definitions(const std::string &func_name);
+    const SplIrAvailableExpressions &
+    get_available_expressions(const std::string &func_name);
+    const SplIrAliasAnalysis &
+    get_alias_analysis(const std::string &func_name);
+    const SplIrCallGraph &get_call_graph();
+    const SplIrFunctionSummaries &get_function_summaries();
+
+    // drop cached analyses a pass declares broken, analyses depending on a
+    // broken one are dropped as well
+    void invalidate(SplIrAnalysisSet broken);
+    void invalidate(const std::string &func_name, SplIrAnalysisSet broken);
+
+    void debug_print_analyses();
+    void debug_benchmark_analyses(int rounds);
+    void debug_benchmark_alias_analysis(int rounds);
+};
+
+class SplIrPass {
+  public:
+    std::string name;
+    // analyses no longer valid once the pass reports a change, note that
+    // rebuilding basic blocks drops every cached analysis anyway
+    SplIrAnalysisSet breaks;
+    std::function<bool(SplIrModule &)> run;
+};
+
+bool run_pass(SplIrModule &ir_module, const SplIrPass &pass);
+
+SplIrAnalysisManager &SplIrModule::analyses() {
+    if (analysis_manager == nullptr) {
+        analysis_manager = std::make_shared<SplIrAnalysisManager>(*this);
+    }
+    return *analysis_manager;
+}
+
+static SplIrAnalysisSet
+spl_ir_analysis_with_dependents(SplIrAnalysisSet broken) {
+    if (broken & SPL_IR_ANALYSIS_REVERSE_POST_ORDER) {
+        broken |= SPL_IR_ANALYSIS_DOMINATOR_TREE;
+    }
+    if (broken & SPL_IR_ANALYSIS_DOMINATOR_TREE) {
+        broken |= SPL_IR_ANALYSIS_NATURAL_LOOPS;
+    }
+    if (broken & SPL_IR_ANALYSIS_CALL_GRAPH) {
+        broken |= SPL_IR_ANALYSIS_FUNCTION_SUMMARIES;
+    }
+    return broken;
+}
+
+void SplIrAnalysisManager::sync() {
+    if (functions_built &&
+        basic_blocks_version == ir_module.basic_blocks_version) {
+        return;
+    }
+    // basic blocks were rebuilt, every cached analysis refers to dead blocks
+    basic_blocks_version = ir_module.basic_blocks_version;
+    functions.clear();
+    func_name_2_function.clear();
+    cache.clear();
+    call_graph = nullptr;
+    function_summaries = nullptr;
+    std::shared_ptr<SplIrFunction> current = nullptr;
+    for (auto &inst : ir_module.ir) {
+        if (inst->type == SplIrInstructionType::FUNCTION) {
+            current = std::make_shared<SplIrFunction>();
+            current->name =
+                std::static_pointer_cast<SplIrFunctionInstruction>(inst)
+                    ->func->repr;
+            functions.push_back(current);
+            func_name_2_function[current->name] = current;
+        }
+        // instructions before the first function are not analyzed
+        if (current == nullptr || inst->parent == nullptr ||
+            current->contains(inst->parent)) {
+            continue;
+        }
+        current->basic_blocks.push_back(inst->parent);
+        current->members.insert(inst->parent.get());
+    }
+    functions_built = true;
+}
+
+const std::vector<std::shared_ptr<SplIrFunction>> &
+SplIrAnalysisManager::get_functions() {
+    sync();
+    return functions;
+}
+
+std::shared_ptr<SplIrFunction>
+SplIrAnalysisManager::get_function(const std::string &func_name) {
+    sync();
+    auto it = func_name_2_function.find(func_name);
+    if (it == func_name_2_function.end()) {
+        throw std::runtime_error("Function " + func_name + " not found");
+    }
+    return it->second;
+}
+
+SplIrAnalysisManager::SplIrFunctionAnalyses &
+SplIrAnalysisManager::get_cache(const std::string &func_name,
+                                SplIrAnalysisType type) {
+    sync();
+    auto &entry = cache[func_name];
+    if (entry.valid & type) {
+        reused_count++;
+    } else {
+        computed_count++;
+    }
+    return entry;
+}
+
+const SplIrReversePostOrder &
+SplIrAnalysisManager::get_reverse_post_order(const std::string &func_name) {
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_REVERSE_POST_ORDER);
+    if (!(entry.valid & SPL_IR_ANALYSIS_REVERSE_POST_ORDER)) {
+        compute_reverse_post_order(*get_function(func_name),
+                                   entry.reverse_post_order);
+        entry.valid |= SPL_IR_ANALYSIS_REVERSE_POST_ORDER;
+    }
+    return entry.reverse_post_order;
+}
+
+const SplIrDominatorTree &
+SplIrAnalysisManager::get_dominator_tree(const std::string &func_name) {
+    auto &rpo = get_reverse_post_order(func_name);
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_DOMINATOR_TREE);
+    if (!(entry.valid & SPL_IR_ANALYSIS_DOMINATOR_TREE)) {
+        compute_dominator_tree(rpo, entry.dominator_tree);
+        entry.valid |= SPL_IR_ANALYSIS_DOMINATOR_TREE;
+    }
+    return entry.dominator_tree;
+}
+
+const SplIrLoopInfo &
+SplIrAnalysisManager::get_natural_loops(const std::string &func_name) {
+    auto &rpo = get_reverse_post_order(func_name);
+    auto &dom = get_dominator_tree(func_name);
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_NATURAL_LOOPS);
+    if (!(entry.valid & SPL_IR_ANALYSIS_NATURAL_LOOPS)) {
+        compute_natural_loops(*get_function(func_name), rpo, dom,
+                              entry.natural_loops);
+        entry.valid |= SPL_IR_ANALYSIS_NATURAL_LOOPS;
+    }
+    return entry.natural_loops;
+}
+
+const SplIrLiveness &
+SplIrAnalysisManager::get_liveness(const std::string &func_name) {
+    auto &rpo = get_reverse_post_order(func_name);
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_LIVENESS);
+    if (!(entry.valid & SPL_IR_ANALYSIS_LIVENESS)) {
+        compute_liveness(*get_function(func_name), rpo, entry.liveness);
+        entry.valid |= SPL_IR_ANALYSIS_LIVENESS;
+    }
+    return entry.liveness;
+}
+
+const SplIrReachingDefinitions &
+SplIrAnalysisManager::get_reaching_definitions(const std::string &func_name) {
+    auto &rpo = get_reverse_post_order(func_name);
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_REACHING_DEFINITIONS);
+    if (!(entry.valid & SPL_IR_ANALYSIS_REACHING_DEFINITIONS)) {
+        compute_reaching_definitions(*get_function(func_name), rpo,
+                                     entry.reaching_definitions);
+        entry.valid |= SPL_IR_ANALYSIS_REACHING_DEFINITIONS;
+    }
+    return entry.reaching_definitions;
+}
+
+const SplIrAvailableExpressions &
+SplIrAnalysisManager::get_available_expressions(const std::string &func_name) {
+    auto &rpo = get_reverse_post_order(func_name);
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_AVAILABLE_EXPRESSIONS);
+    if (!(entry.valid & SPL_IR_ANALYSIS_AVAILABLE_EXPRESSIONS)) {
+        compute_available_expressions(*get_function(func_name), rpo,
+                                      entry.available_expressions);
+        entry.valid |= SPL_IR_ANALYSIS_AVAILABLE_EXPRESSIONS;
+    }
+    return entry.available_expressions;
+}
+
+const SplIrAliasAnalysis &
+SplIrAnalysisManager::get_alias_analysis(const std::string &func_name) {
+    auto &entry = get_cache(func_name, SPL_IR_ANALYSIS_ALIAS);
+    if (!(entry.valid & SPL_IR_ANALYSIS_ALIAS)) {
+        compute_alias_analysis(*get_function(func_name),
+                               entry.alias_analysis);
+        entry.valid |= SPL_IR_ANALYSIS_ALIAS;
+    }
+    return entry.alias_analysis;
+}
+
+const SplIrCallGraph &SplIrAnalysisManager::get_call_graph() {
+    sync();
+    if (call_graph == nullptr) {
+        computed_count++;
+        call_graph = std::make_shared<SplIrCallGraph>(ir_module);
+    } else {
+        reused_count++;
+    }
+    return *call_graph;
+}
+
+const SplIrFunctionSummaries &SplIrAnalysisManager::get_function_summaries() {
+    auto &graph = get_call_graph();
+    if (function_summaries == nullptr) {
+        computed_count++;
+        function_summaries = std::make_shared<SplIrFunctionSummaries>();
+        compute_function_summaries(graph, *function_summaries);
+    } else {
+        reused_count++;
+    }
+    return *function_summaries;
+}
+
+void SplIrAnalysisManager::invalidate(SplIrAnalysisSet broken) {
+    broken = spl_ir_analysis_with_dependents(broken);
+    for (auto &pair : cache) {
+        pair.second.valid &= ~broken;
+    }
+    if (broken & SPL_IR_ANALYSIS_CALL_GRAPH) {
+        call_graph = nullptr;
+    }
+    if (broken & SPL_IR_ANALYSIS_FUNCTION_SUMMARIES) {
+        function_summaries = nullptr;
+    }
+}
+
+void SplIrAnalysisManager::invalidate(const std::string &func_name,
+                                      SplIrAnalysisSet broken) {
+    auto it = cache.find(func_name);
+    if (it != cache.end()) {
+        it->second.valid &= ~spl_ir_analysis_with_dependents(broken);
+    }
+}
+
+void SplIrAnalysisManager::compute_reverse_post_order(
+    const SplIrFunction &function, SplIrReversePostOrder &result) {
+    result.order.clear();
+    result.index.clear();
+    if (function.basic_blocks.empty()) {
+        return;
+    }
+    // iterative dfs, successors outside the function are ignored
+    std::unordered_set<SplIrBasicBlock *> visited;
+    std::vector<std::pair<std::shared_ptr<SplIrBasicBlock>,
+                          SplIrBasicBlockList::iterator>>
+        stack;
+    SplIrBasicBlockVector post_order;
+    auto entry = function.basic_blocks.front();
+    visited.insert(entry.get());
+    stack.emplace_back(entry, entry->successors.begin());
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        if (top.second == top.first->successors.end()) {
+            post_order.push_back(top.first);
+            stack.pop_back();
+            continue;
+        }
+        auto succ = *(top.second++);
+        if (function.contains(succ) && visited.insert(succ.get()).second) {
+            stack.emplace_back(succ, succ->successors.begin());
+        }
+    }
+    result.order.assign(post_order.rbegin(), post_order.rend());
+    for (size_t i = 0; i < result.order.size(); i++) {
+        result.index[result.order[i].get()] = i;
+    }
+}
+
+void SplIrAnalysisManager::compute_dominator_tree(
+    const SplIrReversePostOrder &rpo, SplIrDominatorTree &result) {
+    // Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm"
+    result.idom.clear();
+    result.children.clear();
+    result.interval.clear();
+    result.frontier.clear();
+    if (rpo.order.empty()) {
+        return;
+    }
+    std::vector<int> idom(rpo.order.size(), -1);
+    idom[0] = 0;
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (a > b) {
+                a = idom[a];
+            }
+            while (b > a) {
+                b = idom[b];
+            }
+        }
+        return a;
+    };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < rpo.order.size(); i++) {
+            int new_idom = -1;
+            for (auto &pred : rpo.order[i]->predecessors) {
+                auto it = rpo.index.find(pred.get());
+                if (it == rpo.index.end() || idom[it->second] == -1) {
+                    continue;
+                }
+                int p = it->second;
+                new_idom = new_idom == -1 ? p : intersect(p, new_idom);
+            }
+            if (new_idom != idom[i]) {
+                idom[i] = new_idom;
+                changed = true;
+            }
+        }
+    }
+    result.idom[rpo.order[0].get()] = nullptr;
+    for (size_t i = 1; i < rpo.order.size(); i++) {
+        result.idom[rpo.order[i].get()] = rpo.order[idom[i]];
+        result.children[rpo.order[idom[i]].get()].push_back(rpo.order[i]);
+    }
+    // walk up from each predecessor of a join point until its idom is met,
+    // the join point is in the frontier of every basic block on the way
+    for (size_t i = 1; i < rpo.order.size(); i++) {
+        for (auto &pred : rpo.order[i]->predecessors) {
+            auto it = rpo.index.find(pred.get());
+            if (it == rpo.index.end()) {
+                continue;
+            }
+            for (int runner = it->second; runner != idom[i];
+                 runner = idom[runner]) {
+                auto &frontier = result.frontier[rpo.order[runner].get()];
+                if (!frontier.empty() && frontier.back() == rpo.order[i]) {
+                    break;
+                }
+                frontier.push_back(rpo.order[i]);
+            }
+        }
+    }
+    // number the tree for constant time dominance queries
+    int counter = 0;
+    std::vector<std::pair<std::shared_ptr<SplIrBasicBlock>, size_t>> stack;
+    stack.emplace_back(rpo.order[0], 0);
+    result.interval[rpo.order[0].get()].first = counter++;
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        auto &children = result.get_children(top.first);
+        if (top.second == children.size()) {
+            result.interval[top.first.get()].second = counter++;
+            stack.pop_back();
+            continue;
+        }
+        auto child = children[top.second++];
+        result.interval[child.get()].first = counter++;
+        stack.emplace_back(child, 0);
+    }
+}
+
+void SplIrAnalysisManager::compute_natural_loops(
+    const SplIrFunction &function, const SplIrReversePostOrder &rpo,
+    const SplIrDominatorTree &dom, SplIrLoopInfo &result) {
+    result.loops.clear();
+    result.innermost.clear();
+    // a back edge goes from a basic block to one of its dominators, loops
+    // sharing a header are merged
+    std::unordered_map<SplIrBasicBlock *, std::shared_ptr<SplIrLoop>>
+        header_2_loop;
+    std::vector<std::shared_ptr<SplIrLoop>> loops;
+    for (auto &basic_block : rpo.order) {
+        for (auto &succ : basic_block->successors) {
+            if (!dom.dominates(succ, basic_block)) {
+                continue;
+            }
+            auto &loop = header_2_loop[succ.get()];
+            if (loop == nullptr) {
+                loop = std::make_shared<SplIrLoop>();
+                loop->header = succ;
+                loop->members.insert(succ.get());
+                loops.push_back(loop);
+            }
+            if (std::find(loop->latches.begin(), loop->latches.end(),
+                          basic_block) == loop->latches.end()) {
+                loop->latches.push_back(basic_block);
+            }
+        }
+    }
+    for (auto &loop : loops) {
+        // walk backwards from the latches until the header is met
+        SplIrBasicBlockVector worklist;
+        for (auto &latch : loop->latches) {
+            if (loop->members.insert(latch.get()).second) {
+                worklist.push_back(latch);
+            }
+        }
+        while (!worklist.empty()) {
+            auto basic_block = worklist.back();
+            worklist.pop_back();
+            for (auto &pred : basic_block->predecessors) {
+                if (rpo.is_reachable(pred) &&
+                    loop->members.insert(pred.get()).second) {
+                    worklist.push_back(pred);
+                }
+            }
+        }
+        for (auto &basic_block : function.basic_blocks) {
+            if (loop->contains(basic_block)) {
+                loop->basic_blocks.push_back(basic_block);
+            }
+        }
+    }
+    // nesting, the parent is the smallest loop strictly containing the header
+    std::stable_sort(loops.begin(), loops.end(), [](auto &a, auto &b) {
+        return a->members.size() < b->members.size();
+    });
+    for (size_t i = 0; i < loops.size(); i++) {
+        for (size_t j = i + 1; j < loops.size(); j++) {
+            if (loops[j]->contains(loops[i]->header)) {
+                loops[i]->parent = loops[j].get();
+                break;
+            }
+        }
+    }
+    for (auto &loop : loops) {
+        for (auto parent = loop->parent; parent != nullptr;
+             parent = parent->parent) {
+            loop->depth++;
+        }
+        for (auto &basic_block : loop->basic_blocks) {
+            // inner loops are visited first
+            result.innermost.emplace(basic_block.get(), loop.get());
+        }
+    }
+    result.loops = std::move(loops);
+}
+
+void solve_dataflow(const SplIrFunction &function,
+                    const SplIrReversePostOrder &rpo,
+                    const SplIrDataflowProblem &problem,
+                    SplIrDataflowResult &result) {
+    size_t n = rpo.order.size();
+    bool forward = problem.direction == SplIrDataflowDirection::FORWARD;
+    bool is_union = problem.meet == SplIrDataflowMeet::UNION;
+    // edges between reachable basic blocks of the function, values flow from
+    // sources to sinks
+    std::vector<std::vector<size_t>> sources(n), sinks(n);
+    for (size_t i = 0; i < n; i++) {
+        for (auto &succ : rpo.order[i]->successors) {
+            auto it = rpo.index.find(succ.get());
+            if (!function.contains(succ) || it == rpo.index.end()) {
+                continue;
+            }
+            (forward ? sinks[i] : sources[i]).push_back(it->second);
+            (forward ? sources[it->second] : sinks[it->second]).push_back(i);
+        }
+    }
+    auto &before = forward ? result.in : result.out;
+    auto &after = forward ? result.out : result.in;
+    before.assign(n, SplIrBitVector(problem.width, !is_union));
+    after.assign(n, SplIrBitVector(problem.width, !is_union));
+    // the worklist is a stack, visit basic blocks in reverse post order for
+    // forward problems and in post order for backward problems at first
+    std::vector<size_t> worklist;
+    std::vector<bool> in_worklist(n, true);
+    for (size_t i = 0; i < n; i++) {
+        worklist.push_back(forward ? n - 1 - i : i);
+    }
+    while (!worklist.empty()) {
+        size_t i = worklist.back();
+        worklist.pop_back();
+        in_worklist[i] = false;
+        auto &meet = before[i];
+        if (forward ? i == 0 : sources[i].empty()) {
+            meet = problem.boundary;
+        } else {
+            meet = after[sources[i][0]];
+        }
+        for (auto source : sources[i]) {
+            if (is_union) {
+                meet.union_with(after[source]);
+            } else {
+                meet.intersect_with(after[source]);
+            }
+        }
+        SplIrBitVector transferred = meet;
+        transferred.subtract(problem.kill[i]);
+        transferred.union_with(problem.gen[i]);
+        if (transferred != after[i]) {
+            after[i] = std::move(transferred);
+            for (auto sink : sinks[i]) {
+                if (!in_worklist[sink]) {
+                    in_worklist[sink] = true;
+                    worklist.push_back(sink);
+                }
+            }
+        }
+    }
+}
+
+void SplIrAnalysisManager::compute_liveness(const SplIrFunction &function,
+                                            const SplIrReversePostOrder &rpo,
+                                            SplIrLiveness &result) {
+    result = SplIrLiveness();
+    for (auto &basic_block : rpo.order) {
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            for (auto use : (*it)->uses()) {
+                if ((*use)->is_l_value()) {
+                    result.numbering.add(*use);
+                }
+            }
+            if (auto def = (*it)->def()) {
+                result.numbering.add(*def);
+            }
+        }
+    }
+    SplIrDataflowProblem problem(SplIrDataflowDirection::BACKWARD,
+                                 SplIrDataflowMeet::UNION,
+                                 result.numbering.size(), rpo.order.size());
+    for (size_t i = 0; i < rpo.order.size(); i++) {
+        // gen holds upward exposed uses, kill holds definitions
+        auto &basic_block = rpo.order[i];
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            for (auto use : (*it)->uses()) {
+                auto id = result.numbering.find(*use);
+                if (id != SplIrOperandNumbering::npos &&
+                    !problem.kill[i].test(id)) {
+                    problem.gen[i].set(id);
+                }
+            }
+            if (auto def = (*it)->def()) {
+                problem.kill[i].set(result.numbering.find(*def));
+            }
+        }
+    }
+    SplIrDataflowResult solution;
+    solve_dataflow(function, rpo, problem, solution);
+    for (size_t i = 0; i < rpo.order.size(); i++) {
+        result.live_in[rpo.order[i].get()] = std::move(solution.in[i]);
+        result.live_out[rpo.order[i].get()] = std::move(solution.out[i]);
+    }
+}
+
+void SplIrAnalysisManager::compute_reaching_definitions(
+    const SplIrFunction &function, const SplIrReversePostOrder &rpo,
+    SplIrReachingDefinitions &result) {
+    result = SplIrReachingDefinitions();
+    for (auto &basic_block : rpo.order) {
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            if ((*it)->def() != nullptr) {
+                result.index[it->get()] = result.definitions.size();
+                result.definitions.push_back(*it);
+            }
+        }
+    }
+    size_t width = result.definitions.size();
+    for (size_t id = 0; id < width; id++) {
+        auto op = result.definitions[id]->def()->get();
+        auto it = result.definitions_of.find(op);
+        if (it == result.definitions_of.end()) {
+            it = result.definitions_of.emplace(op, SplIrBitVector(width))
+                     .first;
+        }
+        it->second.set(id);
+    }
+    SplIrDataflowProblem problem(SplIrDataflowDirection::FORWARD,
+                                 SplIrDataflowMeet::UNION, width,
+                                 rpo.order.size());
+    for (size_t i = 0; i < rpo.order.size(); i++) {
+        // a definition kills every other definition of the same operand
+        auto &basic_block = rpo.order[i];
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            if ((*it)->def() == nullptr) {
+                continue;
+            }
+            auto &defs = result.definitions_of.at((*it)->def()->get());
+            problem.gen[i].subtract(defs);
+            problem.gen[i].set(result.index.at(it->get()));
+            problem.kill[i].union_with(defs);
+        }
+    }
+    SplIrDataflowResult solution;
+    solve_dataflow(function, rpo, problem, solution);
+    for (size_t i = 0; i < rpo.order.size(); i++) {
+        result.reach_in[rpo.order[i].get()] = std::move(solution.in[i]);
+        result.reach_out[rpo.order[i].get()] = std::move(solution.out[i]);
+    }
+}
+
+std::string SplIrAvailableExpressions::get_expression_key(
+    const std::shared_ptr<SplIrInstruction> &inst) {
+    const char *op = nullptr;
+    switch (inst->type) {
+    case SplIrInstructionType::ASSIGN_ADD:
+        op = " + ";
+        break;
+    case SplIrInstructionType::ASSIGN_MINUS:
+        op = " - ";
+        break;
+    case SplIrInstructionType::ASSIGN_MUL:
+        op = " * ";
+        break;
+    case SplIrInstructionType::ASSIGN_DIV:
+        op = " / ";
+        break;
+    default:
+        return "";
+    }
+    auto uses = inst->uses();
+    return (*uses[0])->repr + op + (*uses[1])->repr;
+}
+
+void SplIrAnalysisManager::compute_available_expressions(
+    const SplIrFunction &function, const SplIrReversePostOrder &rpo,
+    SplIrAvailableExpressions &result) {
+    result = SplIrAvailableExpressions();
+    // expressions reading each operand, killed when the operand is redefined
+    std::unordered_map<SplIrOperand *, std::vector<size_t>> users;
+    for (auto &basic_block : rpo.order) {
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            auto key = SplIrAvailableExpressions::get_expression_key(*it);
+            if (key.empty() || result.index.count(key) > 0) {
+                continue;
+            }
+            result.index[key] = result.expressions.size();
+            for (auto use : (*it)->uses()) {
+                users[use->get()].push_back(result.expressions.size());
+            }
+            result.expressions.push_back(key);
+        }
+    }
+    size_t width = result.expressions.size();
+    SplIrDataflowProblem problem(SplIrDataflowDirection::FORWARD,
+                                 SplIrDataflowMeet::INTERSECTION, width,
+                                 rpo.order.size());
+    for (size_t i = 0; i < rpo.order.size(); i++) {
+        auto &basic_block = rpo.order[i];
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            auto key = SplIrAvailableExpressions::get_expression_key(*it);
+            if (!key.empty()) {
+                problem.gen[i].set(result.index.at(key));
+            }
+            auto def = (*it)->def();
+            if (def == nullptr || users.count(def->get()) == 0) {
+                continue;
+            }
+            for (auto id : users.at(def->get())) {
+                problem.gen[i].reset(id);
+                problem.kill[i].set(id);
+            }
+        }
+    }
+    SplIrDataflowResult solution;
+    solve_dataflow(function, rpo, problem, solution);
+    for (size_t i = 0; i < rpo.order.size(); i++) {
+        result.avail_in[rpo.order[i].get()] = std::move(solution.in[i]);
+        result.avail_out[rpo.order[i].get()] = std::move(solution.out[i]);
+    }
+}
+
+void SplIrAnalysisManager::compute_alias_analysis(
+    const SplIrFunction &function, SplIrAliasAnalysis &result) {
+    result = SplIrAliasAnalysis();
+    auto get_base = [&](const std::string &name) {
+        auto it = result.base_index.find(name);
+        if (it != result.base_index.end()) {
+            return it->second;
+        }
+        result.base_index[name] = result.bases.size();
+        result.bases.push_back(name);
+        return result.bases.size() - 1;
+    };
+    get_base("#");
+    std::vector<std::shared_ptr<SplIrInstruction>> body;
+    std::unordered_set<std::string> declared;
+    for (auto &basic_block : function.basic_blocks) {
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            body.push_back(*it);
+            if ((*it)->type == SplIrInstructionType::DEC) {
+                declared.insert(
+                    std::static_pointer_cast<SplIrDecInstruction>(*it)
+                        ->variable->repr);
+            }
+        }
+    }
+    // constants are no addresses of memory the function knows, ssa values
+    // start undefined as phi instructions may merge values computed later
+    for (auto &inst : body) {
+        auto def = inst->def();
+        if (def != nullptr && ir_module.ssa_origins.count((*def)->repr) > 0) {
+            result.addresses[def->get()] = SplIrAddress();
+        }
+        for (auto use : inst->uses()) {
+            if ((*use)->type != SplIrOperandType::R_VALUE_CONSTANT ||
+                result.addresses.count(use->get()) > 0) {
+                continue;
+            }
+            SplIrAddress address;
+            char *end = nullptr;
+            long value = std::strtol((*use)->repr.c_str() + 1, &end, 10);
+            if (*end != '\0' || value < INT32_MIN || value > INT32_MAX) {
+                address.kind = SplIrAddress::UNKNOWN;
+            } else {
+                address.kind = SplIrAddress::POINTER;
+                address.offset = value;
+            }
+            result.addresses[use->get()] = address;
+        }
+        if (inst->type == SplIrInstructionType::ASSIGN_ADDRESS &&
+            declared.count(
+                std::static_pointer_cast<SplIrAssignAddressInstruction>(inst)
+                    ->src->repr) == 0) {
+            result.variable_address_taken = true;
+        }
+    }
+    auto merge = [](const SplIrAddress &lhs, const SplIrAddress &rhs) {
+        if (lhs.kind == SplIrAddress::UNDEFINED) {
+            return rhs;
+        }
+        if (rhs.kind == SplIrAddress::UNDEFINED || lhs == rhs) {
+            return lhs;
+        }
+        SplIrAddress address;
+        if (lhs.kind == rhs.kind && lhs.base == rhs.base &&
+            lhs.kind != SplIrAddress::UNKNOWN) {
+            address = lhs;
+            address.offset_known = false;
+            address.symbol = nullptr;
+            address.offset = 0;
+        } else {
+            address.kind = SplIrAddress::UNKNOWN;
+        }
+        return address;
+    };
+    auto is_constant = [](const SplIrAddress &address) {
+        return address.kind == SplIrAddress::POINTER && address.base == 0 &&
+               address.offset_known && address.symbol == nullptr;
+    };
+    // adding a value not known to be an address moves the address by it, a
+    // single ssa value is kept as the symbolic part of the offset
+    auto move = [&](SplIrAddress address, const SplIrAddress &by,
+                    const std::shared_ptr<SplIrOperand> &op, bool negated) {
+        if (is_constant(by)) {
+            if (address.offset_known) {
+                address.offset =
+                    int(uint32_t(address.offset) +
+                        (negated ? 0u - uint32_t(by.offset)
+                                 : uint32_t(by.offset)));
+            }
+            return address;
+        }
+        if (by.kind == SplIrAddress::MEMORY ||
+            by.kind == SplIrAddress::UNKNOWN) {
+            address.kind = SplIrAddress::UNKNOWN;
+        }
+        if (!negated && address.offset_known && address.symbol == nullptr &&
+            by.kind == SplIrAddress::POINTER) {
+            address.symbol = op.get();
+            return address;
+        }
+        address.offset_known = false;
+        address.symbol = nullptr;
+        address.offset = 0;
+        return address;
+    };
+    auto compute = [&](const std::shared_ptr<SplIrInstruction> &inst) {
+        SplIrAddress address;
+        switch (inst->type) {
+        case SplIrInstructionType::ASSIGN:
+            return result.get_address(
+                std::static_pointer_cast<SplIrAssignInstruction>(inst)->src);
+        case SplIrInstructionType::ASSIGN_ADDRESS: {
+            auto &name =
+                std::static_pointer_cast<SplIrAssignAddressInstruction>(inst)
+                    ->src->repr;
+            if (declared.count(name) == 0) {
+                address.kind = SplIrAddress::UNKNOWN;
+                return address;
+            }
+            address.kind = SplIrAddress::MEMORY;
+            address.base = get_base(name);
+            return address;
+        }
+        case SplIrInstructionType::ASSIGN_ADD:
+        case SplIrInstructionType::ASSIGN_MINUS: {
+            auto uses = inst->uses();
+            auto lhs = result.get_address(*uses[0]);
+            auto rhs = result.get_address(*uses[1]);
+            if (lhs.kind == SplIrAddress::UNDEFINED ||
+                rhs.kind == SplIrAddress::UNDEFINED) {
+                return address;
+            }
+            if (inst->type == SplIrInstructionType::ASSIGN_MINUS) {
+                return move(lhs, rhs, *uses[1], true);
+            }
+            // the operand which is a declared memory or a constant tells
+            // which one is the address
+            if (rhs.kind == SplIrAddress::MEMORY || is_constant(lhs)) {
+                return move(rhs, lhs, *uses[0], false);
+            }
+            return move(lhs, rhs, *uses[1], false);
+        }
+        case SplIrInstructionType::PHI:
+            for (auto use : inst->uses()) {
+                address = merge(address, result.get_address(*use));
+            }
+            return address;
+        case SplIrInstructionType::ASSIGN_DEREF_SRC:
+        case SplIrInstructionType::ASSIGN_CALL:
+        case SplIrInstructionType::PARAM:
+        case SplIrInstructionType::READ:
+        case SplIrInstructionType::ASSIGN_MUL:
+        case SplIrInstructionType::ASSIGN_DIV:
+            // pointer values the function does not compute are their own
+            // base
+            address.kind = SplIrAddress::POINTER;
+            address.base = get_base((*inst->def())->repr);
+            return address;
+        default:
+            address.kind = SplIrAddress::UNKNOWN;
+            return address;
+        }
+    };
+    // a single pass in program order settles everything but the addresses
+    // flowing around loops, an address only ever grows less precise
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto &inst : body) {
+            auto def = inst->def();
+            if (def == nullptr || result.addresses.count(def->get()) == 0) {
+                continue;
+            }
+            auto &known = result.addresses[def->get()];
+            auto address = merge(known, compute(inst));
+            if (address != known) {
+                known = address;
+                changed = true;
+            }
+        }
+    }
+    for (auto &pair : result.addresses) {
+        if (pair.second.kind == SplIrAddress::UNDEFINED) {
+            pair.second.kind = SplIrAddress::UNKNOWN;
+        }
+    }
+    // the address of a declared memory escapes once it is used other than
+    // to access memory or to compute another address into it
+    result.escaped.assign(result.bases.size(), false);
+    for (auto &inst : body) {
+        auto def = inst->def();
+        auto defined = def != nullptr ? result.get_address(*def)
+                                      : SplIrAddress();
+        for (auto use : inst->uses()) {
+            auto address = result.get_address(*use);
+            if (address.kind != SplIrAddress::MEMORY) {
+                continue;
+            }
+            bool kept = defined.kind == SplIrAddress::MEMORY &&
+                        defined.base == address.base;
+            bool accessed =
+                inst->type == SplIrInstructionType::ASSIGN_DEREF_SRC ||
+                (inst->type == SplIrInstructionType::ASSIGN_DEREF_DST &&
+                 use == &std::static_pointer_cast<
+                            SplIrAssignDerefDstInstruction>(inst)
+                            ->dst) ||
+                inst->type == SplIrInstructionType::IF_GOTO;
+            if (!kept && !accessed) {
+                result.escaped[address.base] = true;
+            }
+        }
+    }
+}
+
+SplIrCallGraph::SplIrCallGraph(const SplIrModule &ir_module) {
+    std::string current;
+    for (auto &inst : ir_module.ir) {
+        if (inst->type == SplIrInstructionType::FUNCTION) {
+            current = std::static_pointer_cast<SplIrFunctionInstruction>(inst)
+                          ->func->repr;
+            functions.push_back(current);
+            callees[current];
+        } else if (inst->type == SplIrInstructionType::ASSIGN_CALL &&
+                   !current.empty()) {
+            auto &callee =
+                std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                    ->func->repr;
+            auto &func_callees = callees[current];
+            if (std::find(func_callees.begin(), func_callees.end(), callee) ==
+                func_callees.end()) {
+                func_callees.push_back(callee);
+            }
+            call_counts[callee]++;
+        }
+    }
+    for (auto &func_name : functions) {
+        if (index.count(func_name) == 0) {
+            find_components(func_name);
+        }
+    }
+    index.clear();
+    low_link.clear();
+}
+
+void SplIrCallGraph::find_components(const std::string &func_name) {
+    size_t id = index.size();
+    index[func_name] = low_link[func_name] = id;
+    stack.push_back(func_name);
+    on_stack.insert(func_name);
+    auto &func_callees = callees.at(func_name);
+    for (auto &callee : func_callees) {
+        if (callees.count(callee) == 0) {
+            continue;
+        }
+        if (index.count(callee) == 0) {
+            find_components(callee);
+            low_link[func_name] =
+                std::min(low_link[func_name], low_link[callee]);
+        } else if (on_stack.count(callee) > 0) {
+            low_link[func_name] = std::min(low_link[func_name], index[callee]);
+        }
+    }
+    if (low_link[func_name] != id) {
+        return;
+    }
+    components.emplace_back();
+    auto &component = components.back();
+    std::string member;
+    do {
+        member = stack.back();
+        stack.pop_back();
+        on_stack.erase(member);
+        component.push_back(member);
+        component_index[member] = components.size() - 1;
+    } while (member != func_name);
+    // a single function is recursive only if it calls itself
+    if (component.size() > 1 ||
+        std::find(func_callees.begin(), func_callees.end(), func_name) !=
+            func_callees.end()) {
+        recursive.insert(component.begin(), component.end());
+    }
+}
+
+std::unordered_set<std::string>
+SplIrCallGraph::get_reachable(const std::string &func_name) const {
+    std::unordered_set<std::string> reachable;
+    if (!is_defined(func_name)) {
+        return reachable;
+    }
+    std::vector<std::string> worklist{func_name};
+    reachable.insert(func_name);
+    while (!worklist.empty()) {
+        auto current = worklist.back();
+        worklist.pop_back();
+        for (auto &callee : callees.at(current)) {
+            if (is_defined(callee) && reachable.insert(callee).second) {
+                worklist.push_back(callee);
+            }
+        }
+    }
+    return reachable;
+}
+
+void SplIrAnalysisManager::compute_function_summaries(
+    const SplIrCallGraph &call_graph, SplIrFunctionSummaries &result) {
+    // where an address may point to, memory declared by the function, memory
+    // reachable from a parameter, or memory of unknown origin, for values
+    // read from memory, input or calls; products are never addresses
+    enum : unsigned { LOCAL = 1u, PARAM = 2u, UNKNOWN = 4u };
+    std::unordered_map<std::string,
+                       std::vector<std::shared_ptr<SplIrInstruction>>>
+        bodies;
+    std::string current;
+    for (auto &inst : ir_module.ir) {
+        if (inst->type == SplIrInstructionType::FUNCTION) {
+            current = std::static_pointer_cast<SplIrFunctionInstruction>(inst)
+                          ->func->repr;
+        } else if (!current.empty()) {
+            bodies[current].push_back(inst);
+        }
+    }
+    // effects of each function itself, and its calls along with whether
+    // they are passed addresses other than its own memory
+    std::unordered_map<std::string, SplIrFunctionSummary> local;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, bool>>>
+        calls;
+    for (auto &func_name : call_graph.functions) {
+        auto &body = bodies[func_name];
+        std::unordered_map<SplIrOperand *, unsigned> origins;
+        auto get_origin = [&](const std::shared_ptr<SplIrOperand> &op) {
+            auto it = origins.find(op.get());
+            return it == origins.end() ? 0u : it->second;
+        };
+        // flow insensitive, a variable points to wherever any of its
+        // definitions points to
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto &inst : body) {
+                auto def = inst->def();
+                if (def == nullptr) {
+                    continue;
+                }
+                unsigned origin = 0;
+                switch (inst->type) {
+                case SplIrInstructionType::PARAM:
+                    origin = PARAM;
+                    break;
+                case SplIrInstructionType::ASSIGN_ADDRESS:
+                    origin = LOCAL;
+                    break;
+                case SplIrInstructionType::ASSIGN_DEREF_SRC:
+                case SplIrInstructionType::ASSIGN_CALL:
+                case SplIrInstructionType::READ:
+                    origin = UNKNOWN;
+                    break;
+                case SplIrInstructionType::ASSIGN:
+                case SplIrInstructionType::ASSIGN_ADD:
+                case SplIrInstructionType::ASSIGN_MINUS:
+                case SplIrInstructionType::PHI:
+                    for (auto use : inst->uses()) {
+                        origin |= get_origin(*use);
+                    }
+                    break;
+                default:
+                    break;
+                }
+                auto &value = origins[def->get()];
+                if ((value | origin) != value) {
+                    value |= origin;
+                    changed = true;
+                }
+            }
+        }
+        // addresses computed from nothing are not known to be local either
+        auto is_shared = [&](const std::shared_ptr<SplIrOperand> &op) {
+            auto origin = get_origin(op);
+            return origin == 0 || (origin & ~LOCAL) != 0;
+        };
+        auto &summary = local[func_name];
+        bool shared_args = false;
+        for (auto &inst : body) {
+            switch (inst->type) {
+            case SplIrInstructionType::ASSIGN_DEREF_SRC:
+                summary.reads_memory |= is_shared(
+                    std::static_pointer_cast<SplIrAssignDerefSrcInstruction>(
+                        inst)
+                        ->src);
+                break;
+            case SplIrInstructionType::ASSIGN_DEREF_DST:
+                summary.writes_memory |= is_shared(
+                    std::static_pointer_cast<SplIrAssignDerefDstInstruction>(
+                        inst)
+                        ->dst);
+                break;
+            case SplIrInstructionType::READ:
+            case SplIrInstructionType::WRITE:
+                summary.performs_io = true;
+                break;
+            case SplIrInstructionType::ARG:
+                // plain integers have no origin, they are never dereferenced
+                shared_args |=
+                    (get_origin(
+                         std::static_pointer_cast<SplIrArgInstruction>(inst)
+                             ->arg) &
+                     ~LOCAL) != 0;
+                break;
+            case SplIrInstructionType::ASSIGN_CALL:
+                calls[func_name].emplace_back(
+                    std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                        ->func->repr,
+                    shared_args);
+                shared_args = false;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    // callees are summarized before their callers, mutually recursive
+    // functions are iterated until their summaries settle
+    for (auto &component : call_graph.components) {
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto &func_name : component) {
+                auto summary = local[func_name];
+                for (auto &[callee, shared_args] : calls[func_name]) {
+                    auto callee_summary =
+                        call_graph.is_defined(callee)
+                            ? result.summaries[callee]
+                            : result.get_summary(callee);
+                    summary.performs_io |= callee_summary.performs_io;
+                    if (shared_args) {
+                        summary.reads_memory |= callee_summary.reads_memory;
+                        summary.writes_memory |= callee_summary.writes_memory;
+                    }
+                }
+                auto &old = result.summaries[func_name];
+                changed |= old.reads_memory != summary.reads_memory ||
+                           old.writes_memory != summary.writes_memory ||
+                           old.performs_io != summary.performs_io;
+                old = summary;
+            }
+        }
+    }
+}
+
+bool run_pass(SplIrModule &ir_module, const SplIrPass &pass) {
+    bool changed = pass.run(ir_module);
+    if (changed) {
+#ifdef SPL_IR_GENERATOR_DEBUG
+        std::cout << "pass changed ir: " << pass.name << std::endl;
+#endif
+        ir_module.analyses().invalidate(pass.breaks);
+    }
+    return changed;
+}
+
+void SplIrAnalysisManager::debug_print_analyses() {
+    // for debug
+    std::stringstream ss;
+    for (auto &function : get_functions()) {
+        auto &dom = get_dominator_tree(function->name);
+        auto &loops = get_natural_loops(function->name);
+        auto &liveness = get_liveness(function->name);
+        ss << "> " << function->name << ": " << std::endl;
+        for (auto &basic_block : function->basic_blocks) {
+            auto idom = dom.get_idom(basic_block);
+            auto loop = loops.get_loop(basic_block);
+            ss << std::setw(8) << std::left << basic_block->name;
+            ss << std::setw(14) << std::left
+               << ("idom: " + (idom == nullptr ? "-" : idom->name));
+            ss << std::setw(22) << std::left
+               << ("loop: " +
+                   (loop == nullptr ? "-"
+                                    : loop->header->name + " depth " +
+                                          std::to_string(loop->depth)));
+            ss << "live out:";
+            auto it = liveness.live_out.find(basic_block.get());
+            if (it != liveness.live_out.end()) {
+                it->second.for_each([&](size_t id) {
+                    ss << " " << liveness.numbering.operands[id]->repr;
+                });
+            }
+            ss << std::endl;
+        }
+    }
+    ss << "call graph:";
+    for (auto &component : get_call_graph().components) {
+        ss << " {";
+        for (auto &func_name : component) {
+            ss << " " << func_name;
+        }
+        ss << " }";
+    }
+    ss << std::endl;
+    ss << "analyses computed: " << computed_count
+       << ", reused: " << reused_count;
+    std::cout << ss.str() << std::endl;
+}
+
+void SplIrAnalysisManager::debug_benchmark_analyses(int rounds) {
+    // for benchmark, recompute dataflow analyses of every function from
+    // scratch and report the average time of each analysis
+    using clock = std::chrono::steady_clock;
+    size_t basic_block_count = 0, operand_count = 0, definition_count = 0,
+           expression_count = 0;
+    double liveness_ms = 0, reaching_definitions_ms = 0,
+           available_expressions_ms = 0;
+    auto elapsed_ms = [](clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(clock::now() - since)
+            .count();
+    };
+    for (int round = 0; round < rounds; round++) {
+        invalidate(SPL_IR_ANALYSIS_ALL);
+        for (auto &function : get_functions()) {
+            get_reverse_post_order(function->name);
+            auto start = clock::now();
+            auto &liveness = get_liveness(function->name);
+            liveness_ms += elapsed_ms(start);
+            start = clock::now();
+            auto &reaching_definitions =
+                get_reaching_definitions(function->name);
+            reaching_definitions_ms += elapsed_ms(start);
+            start = clock::now();
+            auto &available_expressions =
+                get_available_expressions(function->name);
+            available_expressions_ms += elapsed_ms(start);
+            if (round == 0) {
+                basic_block_count += function->basic_blocks.size();
+                operand_count += liveness.numbering.size();
+                definition_count += reaching_definitions.definitions.size();
+                expression_count +=
+                    available_expressions.expressions.size();
+            }
+        }
+    }
+    std::stringstream ss;
+    ss << "basic blocks: " << basic_block_count
+       << ", operands: " << operand_count
+       << ", definitions: " << definition_count
+       << ", expressions: " << expression_count << std::endl;
+    ss << std::fixed << std::setprecision(3);
+    ss << "liveness: " << liveness_ms / rounds << " ms" << std::endl;
+    ss << "reaching definitions: " << reaching_definitions_ms / rounds << " ms"
+       << std::endl;
+    ss << "available expressions: " << available_expressions_ms / rounds
+       << " ms";
+    std::cerr << ss.str() << std::endl;
+}
+
+void SplIrAnalysisManager::debug_benchmark_alias_analysis(int rounds) {
+    // for benchmark, recompute the alias analysis of every function and query
+    // every pair of memory accesses within a function, on ssa form
+    using clock = std::chrono::steady_clock;
+    size_t address_count = 0, access_count = 0, query_count = 0,
+           may_alias_count = 0, must_alias_count = 0;
+    double analysis_ms = 0, query_ms = 0;
+    auto elapsed_ms = [](clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(clock::now() - since)
+            .count();
+    };
+    for (int round = 0; round < rounds; round++) {
+        invalidate(SPL_IR_ANALYSIS_ALIAS);
+        for (auto &function : get_functions()) {
+            auto start = clock::now();
+            auto &alias = get_alias_analysis(function->name);
+            analysis_ms += elapsed_ms(start);
+            std::vector<std::shared_ptr<SplIrOperand>> pointers;
+            for (auto &basic_block : function->basic_blocks) {
+                for (auto it = basic_block->head;
+                     it != ir_module.ir.end() && (*it)->parent == basic_block;
+                     it++) {
+                    if ((*it)->type == SplIrInstructionType::ASSIGN_DEREF_SRC) {
+                        pointers.push_back(
+                            std::static_pointer_cast<
+                                SplIrAssignDerefSrcInstruction>(*it)
+                                ->src);
+                    } else if ((*it)->type ==
+                               SplIrInstructionType::ASSIGN_DEREF_DST) {
+                        pointers.push_back(
+                            std::static_pointer_cast<
+                                SplIrAssignDerefDstInstruction>(*it)
+                                ->dst);
+                    }
+                }
+            }
+            std::vector<SplIrAddress> addresses;
+            for (auto &pointer : pointers) {
+                addresses.push_back(alias.get_address(pointer));
+            }
+            size_t may = 0, must = 0;
+            start = clock::now();
+            for (size_t i = 0; i < addresses.size(); i++) {
+                for (size_t j = i + 1; j < addresses.size(); j++) {
+                    may += alias.may_alias(addresses[i], addresses[j]);
+                    must += alias.must_alias(addresses[i], addresses[j]);
+                }
+            }
+            query_ms += elapsed_ms(start);
+            if (round == 0) {
+                address_count += alias.addresses.size();
+                access_count += pointers.size();
+                query_count += pointers.size() * (pointers.size() - 1) / 2;
+                may_alias_count += may;
+                must_alias_count += must;
+            }
+        }
+    }
+    std::stringstream ss;
+    ss << "addresses: " << address_count << ", memory accesses: "
+       << access_count << ", pairs: " << query_count
+       << ", may alias: " << may_alias_count
+       << ", must alias: " << must_alias_count << std::endl;
+    ss << std::fixed << std::setprecision(3);
+    ss << "alias analysis: " << analysis_ms / rounds << " ms" << std::endl;
+    ss << "alias queries: " << query_ms / rounds << " ms";
+    std::cerr << ss.str() << std::endl;
+}
+
+#endif /* SPL_IR_ANALYSIS_HPP */
@@ -1,5 +1,8 @@
 #include "spl-ast.hpp"
 #include "spl-enum.hpp"
+#include "spl-ir-analysis.hpp"
+#include "spl-ir-optimizer.hpp"
+#include "spl-ir-ssa.hpp"
 #include "spl-ir.hpp"
 #include "spl-semantic-analyzer-module.cpp"
 #include <algorithm>
@@ -7,12 +10,16 @@
 #include <list>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
 
 extern SplAstNode *prog;
 
 static std::stringstream out;
 
 static std::unordered_map<std::string, std::string> spl_var_name_2_ir_var_name;
+static std::unordered_map<std::string, SplStructLayout> struct_layouts;
+static std::unordered_set<std::string> split_struct_arrays;
+static std::unordered_set<std::string> escaping_structs;
 static SplIrModule ir_module;
 
 void generate_ir();
@@ -35,9 +42,24 @@ std::shared_ptr<SplIrOperand> deref(SplAstNode *now,
                                     SplIrInstructionList &insert_pos);
 std::shared_ptr<SplIrOperand> deref(SplAstNode *now);
 
+const SplStructLayout &get_struct_layout(const std::string &struct_name);
+int get_element_count(const SplExpExactType &type, int from_dim);
+int get_memory_size(const SplExpExactType &type, int from_dim);
+bool is_inner_address(const SplAstNode *now);
+void handle_address(SplAstNode *now);
+void find_split_struct_arrays(SplAstNode *root);
+void find_split_struct_arrays(SplAstNode *now,
+                              std::unordered_set<std::string> &escaped);
+void find_escaping_structs(SplAstNode *root);
+void find_escaping_structs(SplAstNode *now,
+                           std::unordered_set<std::string> &escaped);
+
 void opt_ir();
+void simplify_ir();
 
 void generate_ir() {
+    find_split_struct_arrays(prog);
+    find_escaping_structs(prog);
     traverse_ir(prog);
     collect_ir_by_postorder(prog);
     ir_module.fill_ir(prog->ir);
@@ -64,6 +86,276 @@ std::shared_ptr<SplIrOperand> deref(SplAstNode *now) {
     return deref(now, now->ir);
 }
 
+const SplStructLayout &get_struct_layout(const std::string &struct_name) {
+    auto it = struct_layouts.find(struct_name);
+    if (it != struct_layouts.end()) {
+        return it->second;
+    }
+    auto struct_sym = *symbols.lookup<SplStructSymbol>(struct_name);
+    std::vector<SplStructLayout::SplFieldInfo> fields;
+    for (auto &field : struct_sym->fields) {
+        auto it_count = struct_sym->access_counts.find(field->name);
+        fields.push_back(
+            {field->name, get_memory_size(*field->var_type, 0),
+             it_count == struct_sym->access_counts.end() ? 0
+                                                         : it_count->second});
+    }
+#ifdef SPL_STRUCT_FIELD_REORDERING
+    bool reorder = escaping_structs.count(struct_name) == 0;
+#else
+    bool reorder = false;
+#endif
+    return struct_layouts[struct_name] = SplStructLayout(fields, reorder);
+}
+
+// number of elements of the array along dimensions from from_dim on
+int get_element_count(const SplExpExactType &type, int from_dim) {
+    int count = 1;
+    if (type.dims != nullptr) {
+        for (size_t i = from_dim; i < type.dims->size(); i++) {
+            count *= type.dims->at(i);
+        }
+    }
+    return count;
+}
+
+// size of the memory taken by an element of the array along dimensions from
+// from_dim on, or by a value of the type if it is not an array
+int get_memory_size(const SplExpExactType &type, int from_dim) {
+    int size = type.exp_type == SPL_EXP_STRUCT
+                   ? get_struct_layout(type.struct_name).size
+                   : SPL_WORD_SIZE;
+    return size * get_element_count(type, from_dim);
+}
+
+// the address of an Exp LB Exp RB or Exp DOT ID is left to its parent if
+// that goes on with another one
+bool is_inner_address(const SplAstNode *now) {
+    auto parent = now->parent;
+    return parent->attr.type == SPL_EXP && parent->children.size() >= 3 &&
+           parent->children[0] == now &&
+           (parent->children[1]->attr.type == SPL_LB ||
+            parent->children[1]->attr.type == SPL_DOT);
+}
+
+// address of a chain of Exp LB Exp RB and Exp DOT ID such as s.a.b[2].c,
+// computed as base + index * scale + offset, where constant subscripts and
+// field offsets are folded into offset and the other subscripts into index
+// in horner form, ((i * d1 + j) * d2 + k) for a[i][j][k]
+void handle_address(SplAstNode *now) {
+    std::vector<SplAstNode *> chain;
+    auto base = now;
+    while (base->children.size() >= 3 &&
+           (base->children[1]->attr.type == SPL_LB ||
+            base->children[1]->attr.type == SPL_DOT)) {
+        chain.push_back(base);
+        base = base->children[0];
+    }
+    std::reverse(chain.begin(), chain.end());
+
+    auto &base_ir_var = base->attr.val<SplValExp>().ir_var;
+    // the subscripts of an array split into one array per field count
+    // elements of the field, and its field takes no offset
+    size_t split_levels = 0;
+    int field_size = 0;
+    std::shared_ptr<SplIrOperand> op_addr;
+    if (!base_ir_var.split_array.empty()) {
+        split_levels = base->attr.val<SplValExp>().type->dims->size();
+        auto dot = chain[split_levels];
+        auto &field = dot->children[2]->attr.val<SplValId>().val_id;
+        field_size = get_memory_size(*dot->attr.val<SplValExp>().type, 0);
+        op_addr = ir_module.get_operand_by_name(
+            spl_var_name_2_ir_var_name[base_ir_var.split_array + "." + field]);
+    } else {
+        op_addr = ir_module.get_operand_by_name(base_ir_var.var);
+    }
+
+    std::vector<std::pair<std::shared_ptr<SplIrOperand>, int>> subscripts;
+    int offset = 0;
+    for (size_t i = 0; i < chain.size(); i++) {
+        auto &type = *chain[i]->children[0]->attr.val<SplValExp>().type;
+        if (chain[i]->children[1]->attr.type == SPL_DOT) {
+            auto &field = chain[i]->children[2]->attr.val<SplValId>().val_id;
+            if (split_levels == 0 || i != split_levels) {
+                offset += get_struct_layout(type.struct_name).offsets.at(field);
+            }
+            continue;
+        }
+        int stride = i < split_levels
+                         ? field_size *
+                               get_element_count(type, type.array_idx + 1)
+                         : get_memory_size(type, type.array_idx + 1);
+        auto op_subscript = ir_module.get_operand_by_name(
+            chain[i]->attr.val<SplValExp>().ir_var.var);
+        if (op_subscript->type == SplIrOperandType::R_VALUE_CONSTANT) {
+            offset += std::stoi(op_subscript->repr.substr(1)) * stride;
+        } else {
+            subscripts.emplace_back(op_subscript, stride);
+        }
+    }
+
+    // lhs op #rhs and lhs + rhs into new temporaries
+    auto emit = [&](SplIrInstructionType type,
+                    const std::shared_ptr<SplIrOperand> &lhs, int rhs) {
+        auto op_tmp = ir_module.tmp_counter->next();
+        now->ir.emplace_back(spl_ir_make_arithmetic(
+            type, op_tmp, lhs,
+            ir_module.get_or_make_constant_operand_by_name(
+                "#" + std::to_string(rhs))));
+        return op_tmp;
+    };
+    auto add = [&](const std::shared_ptr<SplIrOperand> &lhs,
+                   const std::shared_ptr<SplIrOperand> &rhs) {
+        auto op_tmp = ir_module.tmp_counter->next();
+        now->ir.emplace_back(
+            std::make_shared<SplIrAssignAddInstruction>(op_tmp, lhs, rhs));
+        return op_tmp;
+    };
+    std::shared_ptr<SplIrOperand> op_index;
+    int scale = 1;
+    auto add_index = [&]() {
+        if (op_index == nullptr) {
+            return;
+        }
+        if (scale != 1) {
+            op_index = emit(SplIrInstructionType::ASSIGN_MUL, op_index, scale);
+        }
+        op_addr = add(op_addr, op_index);
+    };
+    for (auto &[op_subscript, stride] : subscripts) {
+        // a stride not dividing the previous one starts another index, which
+        // happens going into a field of a struct whose size it does not divide
+        if (op_index == nullptr || scale % stride != 0) {
+            add_index();
+            op_index = op_subscript;
+        } else {
+            if (scale != stride) {
+                op_index = emit(SplIrInstructionType::ASSIGN_MUL, op_index,
+                                scale / stride);
+            }
+            op_index = add(op_index, op_subscript);
+        }
+        scale = stride;
+    }
+    add_index();
+    if (offset != 0) {
+        op_addr = emit(SplIrInstructionType::ASSIGN_ADD, op_addr, offset);
+    }
+    now->attr.val<SplValExp>().ir_var = {op_addr->repr, true};
+}
+
+// arrays of structs only accessed field by field, as in a[i][j].f, are
+// split into one array per field, so that loops over a field access memory
+// with unit stride; any other use lets the address of the array or of an
+// element escape, which needs the usual layout
+void find_split_struct_arrays(SplAstNode *root) {
+    std::unordered_set<std::string> escaped;
+    find_split_struct_arrays(root, escaped);
+    for (auto &name : escaped) {
+        split_struct_arrays.erase(name);
+    }
+}
+
+void find_split_struct_arrays(SplAstNode *now,
+                              std::unordered_set<std::string> &escaped) {
+    // fields of struct definitions are no variables
+    if (now->attr.type == SPL_STRUCTSPECIFIER) {
+        return;
+    }
+    auto parent = now->parent;
+    if (now->attr.type == SPL_VARDEC &&
+        (parent->attr.type == SPL_DEC || parent->attr.type == SPL_EXTDECLIST)) {
+        auto &v_vardec = now->attr.val<SplValVarDec>();
+        if (v_vardec.type->exp_type == SPL_EXP_STRUCT &&
+            v_vardec.type->is_array()) {
+            split_struct_arrays.insert(v_vardec.name);
+            // VarDec ASSIGN Exp
+            if (parent->children.size() == 3) {
+                escaped.insert(v_vardec.name);
+            }
+        }
+    } else if (now->attr.type == SPL_EXP && now->children.size() == 1 &&
+               now->children[0]->attr.type == SPL_ID) {
+        // Exp -> ID, followed by an Exp LB Exp RB for each dimension and
+        // then by Exp DOT ID
+        auto &type = *now->attr.val<SplValExp>().type;
+        int levels = type.is_array() ? type.dims->size() : 0;
+        const SplAstNode *exp = now;
+        for (int i = 0; i <= levels && exp != nullptr; i++) {
+            auto next = exp->parent;
+            auto op_type = i < levels ? SPL_LB : SPL_DOT;
+            if (next->attr.type != SPL_EXP || next->children[0] != exp ||
+                next->children[1]->attr.type != op_type) {
+                next = nullptr;
+            }
+            exp = next;
+        }
+        if (exp == nullptr) {
+            escaped.insert(now->children[0]->attr.val<SplValId>().val_id);
+        }
+    }
+    for (auto &child : now->children) {
+        find_split_struct_arrays(child, escaped);
+    }
+}
+
+// the layout of a struct type may only be changed if its instances are
+// reached through Exp DOT ID alone; a struct passed to a function, copied as
+// a whole or nested in such a struct lets its address escape, and so do
+// arrays of it used other than through Exp LB Exp RB
+void find_escaping_structs(SplAstNode *root) {
+    std::unordered_set<std::string> escaped;
+    find_escaping_structs(root, escaped);
+    std::vector<std::string> worklist(escaped.begin(), escaped.end());
+    while (!worklist.empty()) {
+        auto struct_name = worklist.back();
+        worklist.pop_back();
+        if (!escaping_structs.insert(struct_name).second) {
+            continue;
+        }
+        auto struct_sym = *symbols.lookup<SplStructSymbol>(struct_name);
+        for (auto &field : struct_sym->fields) {
+            if (field->var_type->exp_type == SPL_EXP_STRUCT) {
+                worklist.push_back(field->var_type->struct_name);
+            }
+        }
+    }
+}
+
+void find_escaping_structs(SplAstNode *now,
+                           std::unordered_set<std::string> &escaped) {
+    // fields of struct definitions are no variables
+    if (now->attr.type == SPL_STRUCTSPECIFIER) {
+        return;
+    }
+    auto parent = now->parent;
+    if (now->attr.type == SPL_VARDEC && parent->attr.type == SPL_PARAMDEC) {
+        auto &type = *now->attr.val<SplValVarDec>().type;
+        if (type.exp_type == SPL_EXP_STRUCT) {
+            escaped.insert(type.struct_name);
+        }
+    } else if (now->attr.type == SPL_EXP) {
+        auto &type = *now->attr.val<SplValExp>().type;
+        // Exp -> LP Exp RP stands for its inner Exp
+        const SplAstNode *exp = now;
+        while (parent->attr.type == SPL_EXP &&
+               parent->children[0]->attr.type == SPL_LP) {
+            exp = parent;
+            parent = parent->parent;
+        }
+        auto op_type = type.is_array() ? SPL_LB : SPL_DOT;
+        if (type.exp_type == SPL_EXP_STRUCT &&
+            (parent->attr.type != SPL_EXP || parent->children.size() < 3 ||
+             parent->children[0] != exp ||
+             parent->children[1]->attr.type != op_type)) {
+            escaped.insert(type.struct_name);
+        }
+    }
+    for (auto &child : now->children) {
+        find_escaping_structs(child, escaped);
+    }
+}
+
 void handle_fundec(SplAstNode *now) {
     auto &func_name = now->children[0]->attr.val<SplValId>().val_id;
     auto func_symbol = std::static_pointer_cast<SplFunctionSymbol>(
@@ -117,14 +409,37 @@ std::string &handle_vardec(SplAstNode *now) {
     }
     auto &id = tmp->children[0];
     auto &name = id->attr.val<SplValId>().val_id;
-    auto op_var = ir_module.var_counter->next();
-    spl_var_name_2_ir_var_name[name] = op_var->repr;
     auto symbol =
         std::static_pointer_cast<SplVariableSymbol>(*(symbols.lookup(name)));
+    auto &type = *symbol->var_type;
+    if (type.exp_type == SPL_EXP_STRUCT && type.is_array() &&
+        split_struct_arrays.count(name)) {
+        // one array per field, named as name.field
+        auto &layout = get_struct_layout(type.struct_name);
+        int elements = get_element_count(type, 0);
+        auto struct_sym = *symbols.lookup<SplStructSymbol>(type.struct_name);
+        for (auto &field : struct_sym->fields) {
+            if (layout.offsets.count(field->name) == 0) {
+                continue;
+            }
+            auto op_field = ir_module.var_counter->next();
+            spl_var_name_2_ir_var_name[name + "." + field->name] =
+                op_field->repr;
+            auto op_tmp = ir_module.tmp_counter->next();
+            now->ir.emplace_back(std::make_shared<SplIrDecInstruction>(
+                op_tmp, elements * get_memory_size(*field->var_type, 0)));
+            now->ir.emplace_back(
+                std::make_shared<SplIrAssignAddressInstruction>(op_field,
+                                                                op_tmp));
+        }
+        return name;
+    }
+    auto op_var = ir_module.var_counter->next();
+    spl_var_name_2_ir_var_name[name] = op_var->repr;
     if (symbol->var_type->is_array_or_struct()) {
         auto op_tmp = ir_module.tmp_counter->next();
         now->ir.emplace_back(std::make_shared<SplIrDecInstruction>(
-            op_tmp, symbol->var_type->size));
+            op_tmp, get_memory_size(*symbol->var_type, 0)));
 
         now->ir.emplace_back(
             std::make_shared<SplIrAssignAddressInstruction>(op_var, op_tmp));
@@ -182,8 +497,9 @@ void traverse_exp(SplAstNode *now) {
 
         auto label = std::make_shared<SplIrLabelInstruction>(
             ir_module.label_counter->next());
-        // TODO: check correctness
-        now->parent->children[2]->ir.emplace_back(label);
+        // ir of the operator comes between its operands, so the label goes
+        // before everything the rhs computes
+        now->ir.emplace_back(label);
         now->parent->attr.val<SplValExp>().ir_var.label = label;
         return;
     } else if (now->attr.type != SplAstNodeType::SPL_EXP) {
@@ -199,6 +515,12 @@ void traverse_exp(SplAstNode *now) {
         case SplAstNodeType::SPL_ID: {
             // Exp -> ID
             auto &name = now->children[0]->attr.val<SplValId>().val_id;
+            auto &type = *now->attr.val<SplValExp>().type;
+            if (type.exp_type == SPL_EXP_STRUCT && type.is_array() &&
+                split_struct_arrays.count(name)) {
+                now->attr.val<SplValExp>().ir_var.split_array = name;
+                break;
+            }
             now->attr.val<SplValExp>().ir_var = {
                 spl_var_name_2_ir_var_name[name]};
             break;
@@ -370,25 +692,10 @@ void traverse_exp(SplAstNode *now) {
             break;
         }
         case SplAstNodeType::SPL_DOT: {
-            auto struct_sym = (*symbols.lookup<SplStructSymbol>(
-                now->children[0]->attr.val<SplValExp>().type->struct_name));
-            auto offset = struct_sym->get_offset(
-                now->children[2]->attr.val<SplValId>().val_id);
-
-            std::string &base_addr_var =
-                now->children[0]->attr.val<SplValExp>().ir_var.var;
-
-            if (offset == 0) {
-                now->attr.val<SplValExp>().ir_var = {base_addr_var, true};
-                break;
+            // Exp -> Exp DOT ID
+            if (!is_inner_address(now)) {
+                handle_address(now);
             }
-
-            auto op_tmp = ir_module.tmp_counter->next();
-            now->ir.emplace_back(std::make_shared<SplIrAssignAddInstruction>(
-                op_tmp, ir_module.get_operand_by_name(base_addr_var),
-                ir_module.get_or_make_constant_operand_by_name(
-                    "#" + std::to_string(offset))));
-            now->attr.val<SplValExp>().ir_var = {op_tmp->repr, true};
             break;
         }
         case SplAstNodeType::SPL_LP: {
@@ -438,28 +745,12 @@ void traverse_exp(SplAstNode *now) {
         }
         case SplAstNodeType::SPL_LB: {
             // Exp -> Exp LB Exp RB
-            auto arr_size = now->children[0]
-                                ->attr.val<SplValExp>()
-                                .type->get_arr_size_for_current_index();
-            std::string &base_addr_var =
-                now->children[0]->attr.val<SplValExp>().ir_var.var;
-            auto op_base_addr = ir_module.get_operand_by_name(base_addr_var);
-            auto op_accesser = deref(now->children[2]);
-
-            if (op_accesser->repr == "#0") {
-                now->attr.val<SplValExp>().ir_var = {base_addr_var, true};
-                break;
+            // the subscript until the address is computed
+            now->attr.val<SplValExp>().ir_var.var =
+                deref(now->children[2])->repr;
+            if (!is_inner_address(now)) {
+                handle_address(now);
             }
-            auto op_mul = ir_module.tmp_counter->next();
-            auto op_add = ir_module.tmp_counter->next();
-            now->ir.emplace_back(std::make_shared<SplIrAssignMulInstruction>(
-                op_mul, op_accesser,
-                ir_module.get_or_make_constant_operand_by_name(
-                    "#" + std::to_string(arr_size))));
-
-            now->ir.emplace_back(std::make_shared<SplIrAssignAddInstruction>(
-                op_add, op_base_addr, op_mul));
-            now->attr.val<SplValExp>().ir_var = {op_add->repr, true};
             break;
         }
         }
@@ -517,7 +808,9 @@ void handle_stmt(SplAstNode *now) {
     case SPL_WHILE: {
         // WHILE LP Exp RP Stmt
         auto exp_begin_label = ir_module.label_counter->next();
-        now->children[2]->ir.emplace_back(
+        // ir of the exp itself comes after that of its operands, the label
+        // goes with LP to come before all of them
+        now->children[1]->ir.emplace_back(
             std::make_shared<SplIrLabelInstruction>(exp_begin_label));
 
         traverse_exp(now->children[2]);
@@ -617,11 +910,82 @@ void traverse_ir(SplAstNode *now) {
 }
 
 void opt_ir() {
+    simplify_ir();
+#ifdef SPL_IR_MEMOIZATION
+    memoize_functions(ir_module, SPL_IR_MEMOIZATION);
+#endif
+    eliminate_tail_recursion(ir_module);
+    specialize_functions(ir_module);
+    if (inline_functions(ir_module)) {
+        simplify_ir();
+    }
+    eliminate_dead_functions(ir_module);
+    rotate_loops(ir_module);
+    insert_loop_preheaders(ir_module);
+    construct_ssa(ir_module);
+    run_pass(ir_module, {"sparse conditional constant propagation",
+                         SPL_IR_ANALYSIS_ALL, propagate_constants});
+    bool folded = run_pass(ir_module, {"constant call evaluation",
+                                       SPL_IR_ANALYSIS_DATAFLOW,
+                                       evaluate_constant_calls});
+    folded |= run_pass(ir_module, {"algebraic simplification",
+                                   SPL_IR_ANALYSIS_DATAFLOW, simplify_algebra});
+    // constant indices are known once constants are propagated, variables
+    // replacing memory then propagate constants in turn
+    folded |= run_pass(ir_module, {"scalar replacement of aggregates",
+                                   SPL_IR_ANALYSIS_DATAFLOW,
+                                   replace_aggregates});
+    if (folded) {
+        run_pass(ir_module, {"sparse conditional constant propagation",
+                             SPL_IR_ANALYSIS_ALL, propagate_constants});
+    }
+    run_pass(ir_module, {"global value numbering", SPL_IR_ANALYSIS_DATAFLOW,
+                         number_values});
+    run_pass(ir_module, {"loop invariant code motion",
+                         SPL_IR_ANALYSIS_DATAFLOW, hoist_loop_invariants});
+    run_pass(ir_module, {"induction variable strength reduction",
+                         SPL_IR_ANALYSIS_DATAFLOW, reduce_induction_variables});
+    // addresses are compared once value numbering and strength reduction
+    // have settled them
+    if (run_pass(ir_module, {"memory access optimization",
+                             SPL_IR_ANALYSIS_DATAFLOW,
+                             optimize_memory_accesses})) {
+        run_pass(ir_module, {"sparse conditional constant propagation",
+                             SPL_IR_ANALYSIS_ALL, propagate_constants});
+    }
+    run_pass(ir_module, {"dead code elimination", SPL_IR_ANALYSIS_DATAFLOW,
+                         eliminate_dead_code});
+#ifdef SPL_IR_GENERATOR_DEBUG
+    debug_print_ssa(ir_module);
+#endif
+#ifdef SPL_IR_ANALYSIS_BENCHMARK
+    ir_module.analyses().debug_benchmark_alias_analysis(
+        SPL_IR_ANALYSIS_BENCHMARK);
+#endif
+    destruct_ssa(ir_module);
+    simplify_ir();
+    merge_adjacent_labels(ir_module);
+    fold_constant_branches(ir_module);
+    thread_jumps(ir_module);
+    simplify_ir();
+#ifdef SPL_IR_PARTIAL_EVALUATION
+    evaluate_program(ir_module, SPL_IR_PARTIAL_EVALUATION);
+#endif
+#ifdef SPL_IR_GENERATOR_DEBUG
+    ir_module.analyses().debug_print_analyses();
+#endif
+#ifdef SPL_IR_ANALYSIS_BENCHMARK
+    ir_module.analyses().debug_benchmark_analyses(SPL_IR_ANALYSIS_BENCHMARK);
+#endif
+}
+
+void simplify_ir() {
     bool dead_basic_block_eliminated = true;
     bool copy_propagation_eliminated = true;
     bool fall_through_updated = true;
+    bool redundant_copy_eliminated = true;
     while (dead_basic_block_eliminated || copy_propagation_eliminated ||
-           fall_through_updated) {
+           fall_through_updated || redundant_copy_eliminated) {
         {
             dead_basic_block_eliminated = false;
             for (auto it_bb = ir_module.basic_blocks.begin();
@@ -729,6 +1093,10 @@ void opt_ir() {
                                     inst_prev->dst == inst_assign->src;
                                 break;
                             }
+                            case SplIrInstructionType::PHI: {
+                                // simplify_ir never runs in ssa form
+                                break;
+                            }
                             }
                             if (op_is_prev_dst) {
                                 ir_module.replace_usage(*it_inst_prev,
@@ -787,5 +1155,69 @@ void opt_ir() {
                 }
             }
         }
+        {
+            // a copy into a variable already holding its source is dropped,
+            // such as the copy of a rotated loop into the phi of its exit
+            // repeated by the copy into the phi of its preheader; copies hold
+            // on into a basic block whose only predecessor is the one before
+            redundant_copy_eliminated = false;
+            std::unordered_map<std::string, std::string> copies;
+            std::shared_ptr<SplIrBasicBlock> basic_block = nullptr;
+            std::vector<SplIrInstructionList::iterator> redundant;
+            for (auto it_inst = ir_module.ir.begin();
+                 it_inst != ir_module.ir.end(); it_inst++) {
+                auto inst = *it_inst;
+                if (inst->parent != basic_block) {
+                    if (inst->parent == nullptr ||
+                        inst->parent->predecessors.size() != 1 ||
+                        inst->parent->predecessors.front() != basic_block) {
+                        copies.clear();
+                    }
+                    basic_block = inst->parent;
+                }
+                if (inst->type == SplIrInstructionType::ASSIGN) {
+                    auto inst_assign =
+                        std::static_pointer_cast<SplIrAssignInstruction>(inst);
+                    auto it_copy = copies.find(inst_assign->dst->repr);
+                    if (it_copy != copies.end() &&
+                        it_copy->second == inst_assign->src->repr) {
+                        redundant.push_back(it_inst);
+                        continue;
+                    }
+                }
+                // calls and stores may write variables out of sight
+                if (inst->type == SplIrInstructionType::ASSIGN_CALL ||
+                    inst->type == SplIrInstructionType::ASSIGN_DEREF_DST) {
+                    copies.clear();
+                }
+                auto def = inst->def();
+                if (def == nullptr) {
+                    continue;
+                }
+                auto &name = (*def)->repr;
+                copies.erase(name);
+                for (auto it_copy = copies.begin(); it_copy != copies.end();) {
+                    if (it_copy->second == name) {
+                        it_copy = copies.erase(it_copy);
+                    } else {
+                        it_copy++;
+                    }
+                }
+                if (inst->type == SplIrInstructionType::ASSIGN) {
+                    auto inst_assign =
+                        std::static_pointer_cast<SplIrAssignInstruction>(inst);
+                    if (inst_assign->src->repr != name) {
+                        copies[name] = inst_assign->src->repr;
+                    }
+                }
+            }
+            for (auto it_inst : redundant) {
+                ir_module.erase_instruction(it_inst);
+            }
+            if (!redundant.empty()) {
+                ir_module.rebuild_basic_blocks();
+                redundant_copy_eliminated = true;
+            }
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,4212 @@
+#ifndef SPL_IR_OPTIMIZER_HPP
+#define SPL_IR_OPTIMIZER_HPP
+
+#include "spl-ir-analysis.hpp"
+#include "spl-ir-ssa.hpp"
+#include "spl-ir.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// optimization passes, each one returns whether the ir is changed; passes
+// working on the ir in ssa form keep basic blocks as they are (edges may be
+// dropped), the others rebuild basic blocks on change
+
+// sparse conditional constant propagation (Wegman and Zadeck), works on ssa
+// form, operands proved constant are replaced by constants, their definitions
+// are erased and conditional branches on constants are resolved, basic blocks
+// left unreachable are removed once basic blocks are rebuilt
+bool propagate_constants(SplIrModule &ir_module);
+
+// dominator-based global value numbering on ssa form, pure computations
+// are hashed on their operator and the value numbers of their operands, one
+// that is available from a dominating basic block replaces the later ones,
+// phi instructions merging a single value and calls to pure functions are
+// folded as well; copies are left to copy propagation after ssa destruction,
+// folding them here only makes live ranges interfere
+bool number_values(SplIrModule &ir_module);
+
+// dead code elimination on ssa form, the liveness of a definition comes down
+// to whether a live instruction reads it; computations, copies, loads, phi
+// instructions and calls to functions without side effects whose results are
+// dead are removed, while other calls, reads, writes and stores always stay,
+// declared memory goes once its address is no longer taken
+bool eliminate_dead_code(SplIrModule &ir_module);
+
+// forward stored values to later loads of the same address in a basic block,
+// reuse the values of repeated loads and remove stores overwritten before
+// being read, as well as stores to memory that is never loaded and whose
+// address does not escape; addresses are told apart by the alias analysis,
+// works on ssa form
+bool optimize_memory_accesses(SplIrModule &ir_module);
+
+// declared memory of at most this many bytes is split into variables
+#ifndef SPL_IR_SCALAR_REPLACEMENT_THRESHOLD
+#define SPL_IR_SCALAR_REPLACEMENT_THRESHOLD 64
+#endif
+
+// scalar replacement of aggregates, declared memory whose address does not
+// escape and which is only accessed a word at a time at constant offsets,
+// structures and arrays indexed by constants, gets a variable for each word
+// instead, loads and stores become copies and the variables are renamed into
+// ssa form, works on ssa form
+bool replace_aggregates(SplIrModule &ir_module);
+
+// give each loop a preheader, a basic block whose only successor is the
+// header and which every edge entering the loop goes through, works outside
+// ssa form
+bool insert_loop_preheaders(SplIrModule &ir_module);
+
+// move loop invariant computations to the preheader, works on ssa form
+bool hoist_loop_invariants(SplIrModule &ir_module);
+
+// replace multiplications of induction variables in loops by additions
+// carried across iterations and rewrite loop exit tests to use them, works on
+// ssa form
+bool reduce_induction_variables(SplIrModule &ir_module);
+
+// turn while loops into do-while loops behind a copy of the test, so that
+// an iteration ends in a single conditional branch instead of a jump back to
+// the test, works outside ssa form
+bool rotate_loops(SplIrModule &ir_module);
+
+// drop labels directly followed by another label, jumps go to the last one,
+// works outside ssa form
+bool merge_adjacent_labels(SplIrModule &ir_module);
+
+// resolve conditional branches comparing two constants, works outside ssa form
+bool fold_constant_branches(SplIrModule &ir_module);
+
+// retarget branches past jumps and conditions whose outcome is known, remove
+// jumps and labels no longer needed and merge code reached by a single jump
+// into its place, works outside ssa form
+bool thread_jumps(SplIrModule &ir_module);
+
+// callees of at most this many instructions are inlined at every call site
+#ifndef SPL_IR_INLINE_THRESHOLD
+#define SPL_IR_INLINE_THRESHOLD 16
+#endif
+
+// replace calls to small functions and to functions called only once by a
+// copy of the callee with its variables, temporaries and labels renamed,
+// recursive functions are never inlined, works outside ssa form
+bool inline_functions(SplIrModule &ir_module);
+
+// remove functions main never calls, directly or not, works outside ssa form
+bool eliminate_dead_functions(SplIrModule &ir_module);
+
+// turn calls of a function to itself whose result is returned right away
+// into a jump back to its entry after reassigning the parameters, the result
+// of a call added to or multiplied by something before being returned is
+// carried by an accumulator, works outside ssa form
+bool eliminate_tail_recursion(SplIrModule &ir_module);
+
+// functions of at most this many instructions get clones specialized for
+// constant arguments
+#ifndef SPL_IR_SPECIALIZE_THRESHOLD
+#define SPL_IR_SPECIALIZE_THRESHOLD 64
+#endif
+
+// interprocedural constant propagation, a parameter every call site passes
+// the same constant is dropped and assigned that constant in the callee,
+// other combinations of constant arguments, the most frequent first, get a
+// clone of the callee with those parameters replaced likewise, works outside
+// ssa form
+bool specialize_functions(SplIrModule &ir_module);
+
+// instructions executed at most to evaluate a call at compile time
+#ifndef SPL_IR_EVALUATION_FUEL
+#define SPL_IR_EVALUATION_FUEL 100000
+#endif
+
+// replace calls to functions without side effects whose arguments are all
+// constants by the value they return, found by running the callee, calls
+// that run out of fuel or fail are kept, works on ssa form or outside it
+bool evaluate_constant_calls(SplIrModule &ir_module);
+
+// run main at compile time, a program returning within fuel instructions
+// without reading its input is replaced by the writes of the values it
+// outputs, works outside ssa form
+bool evaluate_program(SplIrModule &ir_module, long fuel);
+
+// cache the results of pure functions of a single parameter calling
+// themselves more than once in a table of entries for the arguments from 0
+// up to the one of the outermost call, declared by a wrapper taking the name
+// of the function, works outside ssa form
+bool memoize_functions(SplIrModule &ir_module, int entries);
+
+bool spl_ir_get_constant(const std::shared_ptr<SplIrOperand> &op, int &value) {
+    if (op->type != SplIrOperandType::R_VALUE_CONSTANT) {
+        return false;
+    }
+    char *end = nullptr;
+    long result = std::strtol(op->repr.c_str() + 1, &end, 10);
+    if (*end != '\0' || result < INT32_MIN || result > INT32_MAX) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+std::shared_ptr<SplIrOperand> spl_ir_make_constant(SplIrModule &ir_module,
+                                                   int value) {
+    return ir_module.get_or_make_constant_operand_by_name(
+        "#" + std::to_string(value));
+}
+
+bool spl_ir_is_arithmetic(SplIrInstructionType type) {
+    return type == SplIrInstructionType::ASSIGN_ADD ||
+           type == SplIrInstructionType::ASSIGN_MINUS ||
+           type == SplIrInstructionType::ASSIGN_MUL ||
+           type == SplIrInstructionType::ASSIGN_DIV;
+}
+
+// integers wrap around at 32 bits and division truncates toward zero, while
+// division by zero is left to run time
+bool spl_ir_fold_arithmetic(SplIrInstructionType type, int lhs, int rhs,
+                            int &result) {
+    int64_t value;
+    switch (type) {
+    case SplIrInstructionType::ASSIGN_ADD:
+        value = int64_t(lhs) + rhs;
+        break;
+    case SplIrInstructionType::ASSIGN_MINUS:
+        value = int64_t(lhs) - rhs;
+        break;
+    case SplIrInstructionType::ASSIGN_MUL:
+        value = int64_t(lhs) * rhs;
+        break;
+    case SplIrInstructionType::ASSIGN_DIV:
+        if (rhs == 0) {
+            return false;
+        }
+        value = int64_t(lhs) / rhs;
+        break;
+    default:
+        return false;
+    }
+    result = int32_t(uint32_t(uint64_t(value)));
+    return true;
+}
+
+bool spl_ir_evaluate_relop(SplIrIfGotoInstruction::Relop relop, int lhs,
+                           int rhs) {
+    switch (relop) {
+    case SplIrIfGotoInstruction::EQ:
+        return lhs == rhs;
+    case SplIrIfGotoInstruction::NE:
+        return lhs != rhs;
+    case SplIrIfGotoInstruction::LT:
+        return lhs < rhs;
+    case SplIrIfGotoInstruction::LE:
+        return lhs <= rhs;
+    case SplIrIfGotoInstruction::GT:
+        return lhs > rhs;
+    case SplIrIfGotoInstruction::GE:
+        return lhs >= rhs;
+    }
+    throw std::runtime_error("Invalid relop");
+}
+
+// dereferenced operands must stay l-values
+bool spl_ir_accepts_constant(const std::shared_ptr<SplIrInstruction> &inst,
+                             std::shared_ptr<SplIrOperand> *use) {
+    switch (inst->type) {
+    case SplIrInstructionType::ASSIGN_DEREF_SRC:
+        return false;
+    case SplIrInstructionType::ASSIGN_DEREF_DST:
+        return use !=
+               &std::static_pointer_cast<SplIrAssignDerefDstInstruction>(inst)
+                    ->dst;
+    default:
+        return true;
+    }
+}
+
+// successor of a conditional or unconditional branch jumping to the label
+std::shared_ptr<SplIrBasicBlock>
+spl_ir_get_jump_target(const std::shared_ptr<SplIrBasicBlock> &basic_block,
+                       const std::shared_ptr<SplIrOperand> &label) {
+    for (auto &succ : basic_block->successors) {
+        auto &head = *succ->head;
+        if (head->type == SplIrInstructionType::LABEL &&
+            std::static_pointer_cast<SplIrLabelInstruction>(head)->label ==
+                label) {
+            return succ;
+        }
+    }
+    return nullptr;
+}
+
+class SplIrConstantPropagation {
+  private:
+    enum class Level { TOP, CONSTANT, BOTTOM };
+    struct Value {
+        Level level = Level::TOP;
+        int constant = 0;
+        bool operator!=(const Value &rhs) const {
+            return level != rhs.level ||
+                   (level == Level::CONSTANT && constant != rhs.constant);
+        }
+    };
+
+    SplIrModule &ir_module;
+    const SplIrFunction &function;
+    // operands defined exactly once in the function, others are never known
+    std::unordered_map<SplIrOperand *, int> definition_count;
+    std::unordered_map<SplIrOperand *,
+                       std::vector<SplIrInstructionList::iterator>>
+        users;
+    std::unordered_map<SplIrOperand *, Value> values;
+    std::set<std::pair<SplIrBasicBlock *, SplIrBasicBlock *>> executable_edges;
+    std::unordered_set<SplIrBasicBlock *> executable_basic_blocks;
+    std::vector<std::pair<std::shared_ptr<SplIrBasicBlock>,
+                          std::shared_ptr<SplIrBasicBlock>>>
+        flow_worklist;
+    std::vector<SplIrInstructionList::iterator> ssa_worklist;
+
+    static Value meet(const Value &a, const Value &b) {
+        if (a.level == Level::TOP) {
+            return b;
+        }
+        if (b.level == Level::TOP) {
+            return a;
+        }
+        if (a.level == Level::CONSTANT && b.level == Level::CONSTANT &&
+            a.constant == b.constant) {
+            return a;
+        }
+        return {Level::BOTTOM};
+    }
+
+    Value get_value(const std::shared_ptr<SplIrOperand> &op) {
+        int constant;
+        if (spl_ir_get_constant(op, constant)) {
+            return {Level::CONSTANT, constant};
+        }
+        auto it = definition_count.find(op.get());
+        if (it == definition_count.end() || it->second != 1) {
+            return {Level::BOTTOM};
+        }
+        return values[op.get()];
+    }
+
+    void lower(const std::shared_ptr<SplIrOperand> &op, const Value &value) {
+        auto &current = values[op.get()];
+        auto lowered = meet(current, value);
+        if (lowered != current) {
+            current = lowered;
+            auto &op_users = users[op.get()];
+            ssa_worklist.insert(ssa_worklist.end(), op_users.begin(),
+                                op_users.end());
+        }
+    }
+
+    void mark_edge(const std::shared_ptr<SplIrBasicBlock> &from,
+                   const std::shared_ptr<SplIrBasicBlock> &to) {
+        if (to != nullptr && function.contains(to) &&
+            executable_edges.emplace(from.get(), to.get()).second) {
+            flow_worklist.emplace_back(from, to);
+        }
+    }
+
+    void visit(SplIrInstructionList::iterator it) {
+        auto &inst = *it;
+        auto basic_block = inst->parent;
+        switch (inst->type) {
+        case SplIrInstructionType::PHI: {
+            auto phi = std::static_pointer_cast<SplIrPhiInstruction>(inst);
+            Value value;
+            for (auto &incoming : phi->incomings) {
+                if (executable_edges.count(
+                        {incoming.first.get(), basic_block.get()}) > 0) {
+                    value = meet(value, get_value(incoming.second));
+                }
+            }
+            lower(phi->dst, value);
+            break;
+        }
+        case SplIrInstructionType::ASSIGN: {
+            auto assign =
+                std::static_pointer_cast<SplIrAssignInstruction>(inst);
+            lower(assign->dst, get_value(assign->src));
+            break;
+        }
+        case SplIrInstructionType::ASSIGN_ADD:
+        case SplIrInstructionType::ASSIGN_MINUS:
+        case SplIrInstructionType::ASSIGN_MUL:
+        case SplIrInstructionType::ASSIGN_DIV: {
+            auto uses = inst->uses();
+            auto lhs = get_value(*uses[0]), rhs = get_value(*uses[1]);
+            Value value;
+            if (lhs.level == Level::BOTTOM || rhs.level == Level::BOTTOM) {
+                value.level = Level::BOTTOM;
+            } else if (lhs.level == Level::CONSTANT &&
+                       rhs.level == Level::CONSTANT) {
+                value.level = spl_ir_fold_arithmetic(inst->type, lhs.constant,
+                                                     rhs.constant,
+                                                     value.constant)
+                                  ? Level::CONSTANT
+                                  : Level::BOTTOM;
+            }
+            lower(*inst->def(), value);
+            break;
+        }
+        case SplIrInstructionType::GOTO: {
+            auto inst_goto =
+                std::static_pointer_cast<SplIrGotoInstruction>(inst);
+            mark_edge(basic_block, spl_ir_get_jump_target(
+                                       basic_block, inst_goto->label.value()));
+            return;
+        }
+        case SplIrInstructionType::IF_GOTO: {
+            auto inst_if_goto =
+                std::static_pointer_cast<SplIrIfGotoInstruction>(inst);
+            auto lhs = get_value(inst_if_goto->lhs),
+                 rhs = get_value(inst_if_goto->rhs);
+            auto target = spl_ir_get_jump_target(basic_block,
+                                                 inst_if_goto->label.value());
+            auto next = std::next(it);
+            auto fall_through =
+                next == ir_module.ir.end() ? nullptr : (*next)->parent;
+            if (lhs.level == Level::BOTTOM || rhs.level == Level::BOTTOM) {
+                mark_edge(basic_block, target);
+                mark_edge(basic_block, fall_through);
+            } else if (lhs.level == Level::CONSTANT &&
+                       rhs.level == Level::CONSTANT) {
+                mark_edge(basic_block,
+                          spl_ir_evaluate_relop(inst_if_goto->relop,
+                                                lhs.constant, rhs.constant)
+                              ? target
+                              : fall_through);
+            }
+            return;
+        }
+        case SplIrInstructionType::RETURN:
+            return;
+        default: {
+            if (auto def = inst->def()) {
+                lower(*def, {Level::BOTTOM});
+            }
+            break;
+        }
+        }
+        // fall through to the next basic block
+        auto next = std::next(it);
+        if (next == ir_module.ir.end() || (*next)->parent != basic_block) {
+            for (auto &succ : basic_block->successors) {
+                mark_edge(basic_block, succ);
+            }
+        }
+    }
+
+    void visit_basic_block(const std::shared_ptr<SplIrBasicBlock> &basic_block,
+                           bool phi_only) {
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            if (!phi_only || (*it)->type == SplIrInstructionType::PHI) {
+                visit(it);
+            }
+        }
+    }
+
+    void solve() {
+        auto entry = function.basic_blocks.front();
+        executable_basic_blocks.insert(entry.get());
+        visit_basic_block(entry, false);
+        while (!flow_worklist.empty() || !ssa_worklist.empty()) {
+            if (!flow_worklist.empty()) {
+                auto edge = flow_worklist.back();
+                flow_worklist.pop_back();
+                // phi instructions see one more incoming value
+                bool first_visit =
+                    executable_basic_blocks.insert(edge.second.get()).second;
+                visit_basic_block(edge.second, !first_visit);
+                continue;
+            }
+            auto it = ssa_worklist.back();
+            ssa_worklist.pop_back();
+            if (executable_basic_blocks.count((*it)->parent.get()) > 0) {
+                visit(it);
+            }
+        }
+    }
+
+    // returns whether the branch is resolved
+    bool fold_branch(SplIrInstructionList::iterator it) {
+        auto inst_if_goto =
+            std::static_pointer_cast<SplIrIfGotoInstruction>(*it);
+        int lhs, rhs;
+        if (!spl_ir_get_constant(inst_if_goto->lhs, lhs) ||
+            !spl_ir_get_constant(inst_if_goto->rhs, rhs)) {
+            return false;
+        }
+        auto basic_block = inst_if_goto->parent;
+        auto label = inst_if_goto->label.value();
+        auto target = spl_ir_get_jump_target(basic_block, label);
+        auto next = std::next(it);
+        if (target == nullptr || next == ir_module.ir.end()) {
+            return false;
+        }
+        auto fall_through = (*next)->parent;
+        if (spl_ir_evaluate_relop(inst_if_goto->relop, lhs, rhs)) {
+            ir_module.replace_instruction(
+                it, std::make_shared<SplIrGotoInstruction>(label));
+            remove_control_flow_edge(ir_module, basic_block, fall_through);
+            return true;
+        }
+        // the only instruction of a basic block is left to
+        // fold_constant_branches
+        if (!ir_module.erase_instruction_in_place(it)) {
+            return false;
+        }
+        remove_control_flow_edge(ir_module, basic_block, target);
+        return true;
+    }
+
+  public:
+    SplIrConstantPropagation(SplIrModule &ir_module,
+                             const SplIrFunction &function)
+        : ir_module(ir_module), function(function) {}
+
+    bool run() {
+        if (function.basic_blocks.empty()) {
+            return false;
+        }
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                if (auto def = (*it)->def()) {
+                    definition_count[def->get()]++;
+                }
+                for (auto use : (*it)->uses()) {
+                    if ((*use)->is_l_value()) {
+                        users[use->get()].push_back(it);
+                    }
+                }
+            }
+        }
+        solve();
+        bool changed = false;
+        std::vector<SplIrInstructionList::iterator> constant_definitions,
+            branches;
+        for (auto &basic_block : function.basic_blocks) {
+            if (executable_basic_blocks.count(basic_block.get()) == 0) {
+                continue;
+            }
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                auto &inst = *it;
+                auto def = inst->def();
+                if (def != nullptr &&
+                    get_value(*def).level == Level::CONSTANT &&
+                    (inst->type == SplIrInstructionType::ASSIGN ||
+                     inst->type == SplIrInstructionType::PHI ||
+                     spl_ir_is_arithmetic(inst->type))) {
+                    constant_definitions.push_back(it);
+                    continue;
+                }
+                for (auto use : inst->uses()) {
+                    auto value = get_value(*use);
+                    if ((*use)->is_l_value() &&
+                        value.level == Level::CONSTANT &&
+                        spl_ir_accepts_constant(inst, use)) {
+                        *use = spl_ir_make_constant(ir_module, value.constant);
+                        changed = true;
+                    }
+                }
+                if (inst->type == SplIrInstructionType::IF_GOTO) {
+                    branches.push_back(it);
+                }
+            }
+        }
+        // every use of a constant definition is replaced, the only instruction
+        // of a basic block is kept as a copy of the constant
+        for (auto it : constant_definitions) {
+            if (ir_module.erase_instruction_in_place(it)) {
+                changed = true;
+                continue;
+            }
+            auto def = *(*it)->def();
+            int constant;
+            if ((*it)->type == SplIrInstructionType::ASSIGN &&
+                spl_ir_get_constant(
+                    std::static_pointer_cast<SplIrAssignInstruction>(*it)->src,
+                    constant)) {
+                continue;
+            }
+            ir_module.replace_instruction(
+                it, std::make_shared<SplIrAssignInstruction>(
+                        def, spl_ir_make_constant(ir_module,
+                                                  get_value(def).constant)));
+            changed = true;
+        }
+        for (auto it : branches) {
+            changed |= fold_branch(it);
+        }
+        return changed;
+    }
+};
+
+bool propagate_constants(SplIrModule &ir_module) {
+    bool changed = false;
+    for (auto &function : ir_module.analyses().get_functions()) {
+        SplIrConstantPropagation propagation(ir_module, *function);
+        changed |= propagation.run();
+    }
+    if (changed) {
+        ir_module.rebuild_use_lists();
+    }
+    return changed;
+}
+
+// sum of constant multiples of operands plus a constant, coefficients wrap
+// around at 32 bits just like values do
+struct SplIrLinearForm {
+    using Term = std::pair<std::shared_ptr<SplIrOperand>, int>;
+    std::vector<Term> terms;
+    int constant = 0;
+
+    void add_term(const std::shared_ptr<SplIrOperand> &op, int coefficient) {
+        for (auto &term : terms) {
+            if (term.first == op) {
+                spl_ir_fold_arithmetic(SplIrInstructionType::ASSIGN_ADD,
+                                       term.second, coefficient, term.second);
+                return;
+            }
+        }
+        terms.emplace_back(op, coefficient);
+    }
+    void add_constant(int value) {
+        spl_ir_fold_arithmetic(SplIrInstructionType::ASSIGN_ADD, constant,
+                               value, constant);
+    }
+};
+
+int spl_ir_add(int lhs, int rhs) {
+    int result;
+    spl_ir_fold_arithmetic(SplIrInstructionType::ASSIGN_ADD, lhs, rhs, result);
+    return result;
+}
+
+int spl_ir_multiply(int lhs, int rhs) {
+    int result;
+    spl_ir_fold_arithmetic(SplIrInstructionType::ASSIGN_MUL, lhs, rhs, result);
+    return result;
+}
+
+std::shared_ptr<SplIrInstruction>
+spl_ir_make_arithmetic(SplIrInstructionType type,
+                       const std::shared_ptr<SplIrOperand> &dst,
+                       const std::shared_ptr<SplIrOperand> &lhs,
+                       const std::shared_ptr<SplIrOperand> &rhs) {
+    switch (type) {
+    case SplIrInstructionType::ASSIGN_ADD:
+        return std::make_shared<SplIrAssignAddInstruction>(dst, lhs, rhs);
+    case SplIrInstructionType::ASSIGN_MINUS:
+        return std::make_shared<SplIrAssignMinusInstruction>(dst, lhs, rhs);
+    case SplIrInstructionType::ASSIGN_MUL:
+        return std::make_shared<SplIrAssignMulInstruction>(dst, lhs, rhs);
+    case SplIrInstructionType::ASSIGN_DIV:
+        return std::make_shared<SplIrAssignDivInstruction>(dst, lhs, rhs);
+    default:
+        throw std::runtime_error("Invalid arithmetic instruction type");
+    }
+}
+
+// the instruction after the last one of the function starting at entry
+SplIrInstructionList::iterator
+spl_ir_get_function_end(SplIrModule &ir_module,
+                        SplIrInstructionList::iterator entry) {
+    auto it = std::next(entry);
+    while (it != ir_module.ir.end() &&
+           (*it)->type != SplIrInstructionType::FUNCTION) {
+        it++;
+    }
+    return it;
+}
+
+using SplIrOperandRenaming =
+    std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>>;
+
+// a fresh variable, temporary or label standing for op in a copy of code,
+// the same one each time op is renamed, other operands are kept
+std::shared_ptr<SplIrOperand>
+spl_ir_rename_operand(SplIrModule &ir_module, SplIrOperandRenaming &renamed,
+                      const std::shared_ptr<SplIrOperand> &op) {
+    if (!op->is_l_value() && !op->is_label()) {
+        return op;
+    }
+    auto &result = renamed[op.get()];
+    if (result == nullptr) {
+        if (op->is_label()) {
+            result = ir_module.label_counter->next();
+        } else if (op->is_l_value_variable()) {
+            result = ir_module.var_counter->next();
+        } else {
+            result = ir_module.tmp_counter->next();
+        }
+    }
+    return result;
+}
+
+// the ARG instructions of a call, which come right before it, nearest first,
+// so the k-th of them is passed to the k-th parameter
+std::vector<SplIrInstructionList::iterator>
+spl_ir_get_call_args(SplIrModule &ir_module,
+                     SplIrInstructionList::iterator call) {
+    std::vector<SplIrInstructionList::iterator> args;
+    for (auto it = call; it != ir_module.ir.begin() &&
+                         (*std::prev(it))->type == SplIrInstructionType::ARG;
+         it--) {
+        args.push_back(std::prev(it));
+    }
+    return args;
+}
+
+// erase a call along with its arguments, a call left as the only instruction
+// of its basic block becomes a copy of value instead
+void spl_ir_erase_call(SplIrModule &ir_module,
+                       SplIrInstructionList::iterator call,
+                       const std::shared_ptr<SplIrOperand> &value) {
+    for (auto it : spl_ir_get_call_args(ir_module, call)) {
+        ir_module.erase_instruction_in_place(it);
+    }
+    if (!ir_module.erase_instruction_in_place(call)) {
+        ir_module.replace_instruction(
+            call, std::make_shared<SplIrAssignInstruction>(*(*call)->def(),
+                                                           value));
+    }
+}
+
+// erase a dead definition, one left as the only instruction of its basic
+// block becomes a copy of #0 instead so that it reads no other definition
+bool spl_ir_erase_definition(SplIrModule &ir_module,
+                             SplIrInstructionList::iterator it) {
+    if (ir_module.erase_instruction_in_place(it)) {
+        return true;
+    }
+    auto def = (*it)->def();
+    int constant;
+    if (def == nullptr ||
+        ((*it)->type == SplIrInstructionType::ASSIGN &&
+         spl_ir_get_constant(
+             std::static_pointer_cast<SplIrAssignInstruction>(*it)->src,
+             constant))) {
+        return false;
+    }
+    ir_module.replace_instruction(
+        it, std::make_shared<SplIrAssignInstruction>(
+                *def, spl_ir_make_constant(ir_module, 0)));
+    return true;
+}
+
+// a copy of the instruction referring to the same operands, phi
+// instructions included
+std::shared_ptr<SplIrInstruction>
+spl_ir_clone_instruction(const std::shared_ptr<SplIrInstruction> &inst) {
+    switch (inst->type) {
+    case SplIrInstructionType::LABEL:
+        return std::make_shared<SplIrLabelInstruction>(
+            std::static_pointer_cast<SplIrLabelInstruction>(inst)->label);
+    case SplIrInstructionType::FUNCTION:
+        return std::make_shared<SplIrFunctionInstruction>(
+            std::static_pointer_cast<SplIrFunctionInstruction>(inst)->func);
+    case SplIrInstructionType::ASSIGN: {
+        auto inst_assign =
+            std::static_pointer_cast<SplIrAssignInstruction>(inst);
+        return std::make_shared<SplIrAssignInstruction>(inst_assign->dst,
+                                                        inst_assign->src);
+    }
+    case SplIrInstructionType::ASSIGN_ADD:
+    case SplIrInstructionType::ASSIGN_MINUS:
+    case SplIrInstructionType::ASSIGN_MUL:
+    case SplIrInstructionType::ASSIGN_DIV: {
+        auto uses = inst->uses();
+        return spl_ir_make_arithmetic(inst->type, *inst->def(), *uses[0],
+                                      *uses[1]);
+    }
+    case SplIrInstructionType::ASSIGN_ADDRESS: {
+        auto inst_address =
+            std::static_pointer_cast<SplIrAssignAddressInstruction>(inst);
+        return std::make_shared<SplIrAssignAddressInstruction>(
+            inst_address->dst, inst_address->src);
+    }
+    case SplIrInstructionType::ASSIGN_DEREF_SRC: {
+        auto inst_deref =
+            std::static_pointer_cast<SplIrAssignDerefSrcInstruction>(inst);
+        return std::make_shared<SplIrAssignDerefSrcInstruction>(
+            inst_deref->dst, inst_deref->src);
+    }
+    case SplIrInstructionType::ASSIGN_DEREF_DST: {
+        auto inst_deref =
+            std::static_pointer_cast<SplIrAssignDerefDstInstruction>(inst);
+        return std::make_shared<SplIrAssignDerefDstInstruction>(
+            inst_deref->dst, inst_deref->src);
+    }
+    case SplIrInstructionType::GOTO:
+        return std::make_shared<SplIrGotoInstruction>(
+            std::static_pointer_cast<SplIrGotoInstruction>(inst)
+                ->label.value());
+    case SplIrInstructionType::IF_GOTO: {
+        auto inst_if_goto =
+            std::static_pointer_cast<SplIrIfGotoInstruction>(inst);
+        auto result = std::make_shared<SplIrIfGotoInstruction>(
+            inst_if_goto->lhs, inst_if_goto->rhs, inst_if_goto->relop);
+        result->patch(inst_if_goto->label.value());
+        return result;
+    }
+    case SplIrInstructionType::RETURN:
+        return std::make_shared<SplIrReturnInstruction>(
+            std::static_pointer_cast<SplIrReturnInstruction>(inst)->src);
+    case SplIrInstructionType::DEC: {
+        auto inst_dec = std::static_pointer_cast<SplIrDecInstruction>(inst);
+        return std::make_shared<SplIrDecInstruction>(inst_dec->variable,
+                                                     inst_dec->size);
+    }
+    case SplIrInstructionType::ARG:
+        return std::make_shared<SplIrArgInstruction>(
+            std::static_pointer_cast<SplIrArgInstruction>(inst)->arg);
+    case SplIrInstructionType::ASSIGN_CALL: {
+        auto inst_call =
+            std::static_pointer_cast<SplIrAssignCallInstruction>(inst);
+        return std::make_shared<SplIrAssignCallInstruction>(inst_call->dst,
+                                                            inst_call->func);
+    }
+    case SplIrInstructionType::PARAM:
+        return std::make_shared<SplIrParamInstruction>(
+            std::static_pointer_cast<SplIrParamInstruction>(inst)->param);
+    case SplIrInstructionType::READ:
+        return std::make_shared<SplIrReadInstruction>(
+            std::static_pointer_cast<SplIrReadInstruction>(inst)->dst);
+    case SplIrInstructionType::WRITE:
+        return std::make_shared<SplIrWriteInstruction>(
+            std::static_pointer_cast<SplIrWriteInstruction>(inst)->src);
+    case SplIrInstructionType::PHI: {
+        auto inst_phi = std::static_pointer_cast<SplIrPhiInstruction>(inst);
+        auto result = std::make_shared<SplIrPhiInstruction>(inst_phi->dst);
+        for (auto &[pred, value] : inst_phi->incomings) {
+            result->add_incoming(pred, value);
+        }
+        return result;
+    }
+    }
+    throw std::runtime_error("Invalid instruction type");
+}
+
+// positive terms are added up first and negative ones subtracted, the
+// constant goes last unless there is nothing to subtract it from
+void spl_ir_split_terms(const SplIrLinearForm &form,
+                        std::vector<SplIrLinearForm::Term> &positive,
+                        std::vector<SplIrLinearForm::Term> &negative) {
+    for (auto &term : form.terms) {
+        if (term.second > 0 || term.second == INT32_MIN) {
+            positive.push_back(term);
+        } else if (term.second < 0) {
+            negative.emplace_back(term.first, -term.second);
+        }
+    }
+}
+
+// number of arithmetic instructions emitted for the form, a copy is
+// emitted if there is none
+size_t spl_ir_count_instructions(const SplIrLinearForm &form) {
+    std::vector<SplIrLinearForm::Term> positive, negative;
+    spl_ir_split_terms(form, positive, negative);
+    size_t count = negative.size();
+    if (!positive.empty()) {
+        count += positive.size() - 1 + (form.constant != 0);
+    }
+    for (auto &term : form.terms) {
+        count += term.second != 0 && term.second != 1 && term.second != -1;
+    }
+    return count;
+}
+
+std::vector<std::shared_ptr<SplIrInstruction>>
+spl_ir_emit_linear_form(SplIrModule &ir_module, const SplIrLinearForm &form,
+                        const std::shared_ptr<SplIrOperand> &dst) {
+    std::vector<std::shared_ptr<SplIrInstruction>> result;
+    std::vector<SplIrLinearForm::Term> positive, negative;
+    spl_ir_split_terms(form, positive, negative);
+    // the last instruction defines dst
+    size_t remaining = spl_ir_count_instructions(form);
+    auto push = [&](SplIrInstructionType type,
+                    const std::shared_ptr<SplIrOperand> &lhs,
+                    const std::shared_ptr<SplIrOperand> &rhs) {
+        auto inst_dst = --remaining == 0 ? dst : make_ssa_temporary(ir_module);
+        result.push_back(spl_ir_make_arithmetic(type, inst_dst, lhs, rhs));
+        return inst_dst;
+    };
+    auto multiple = [&](const SplIrLinearForm::Term &term) {
+        if (term.second == 1) {
+            return term.first;
+        }
+        return push(SplIrInstructionType::ASSIGN_MUL, term.first,
+                    spl_ir_make_constant(ir_module, term.second));
+    };
+    std::shared_ptr<SplIrOperand> acc = nullptr;
+    for (auto &term : positive) {
+        auto value = multiple(term);
+        acc = acc == nullptr
+                  ? value
+                  : push(SplIrInstructionType::ASSIGN_ADD, acc, value);
+    }
+    bool constant_pending = true;
+    if (acc == nullptr) {
+        acc = spl_ir_make_constant(ir_module, form.constant);
+        constant_pending = false;
+    }
+    for (auto &term : negative) {
+        acc = push(SplIrInstructionType::ASSIGN_MINUS, acc, multiple(term));
+    }
+    if (constant_pending && form.constant < 0 && form.constant != INT32_MIN) {
+        acc = push(SplIrInstructionType::ASSIGN_MINUS, acc,
+                   spl_ir_make_constant(ir_module, -form.constant));
+    } else if (constant_pending && form.constant != 0) {
+        acc = push(SplIrInstructionType::ASSIGN_ADD, acc,
+                   spl_ir_make_constant(ir_module, form.constant));
+    }
+    if (result.empty()) {
+        result.push_back(std::make_shared<SplIrAssignInstruction>(dst, acc));
+    }
+    return result;
+}
+
+class SplIrAlgebraicSimplifier {
+  private:
+    SplIrModule &ir_module;
+    const SplIrFunction &function;
+    // definitions of ssa values and how many times each operand is read
+    std::unordered_map<SplIrOperand *, SplIrInstructionList::iterator>
+        definitions;
+    std::unordered_map<SplIrOperand *, int> use_count;
+    // definitions flattened into the form of the current instruction
+    std::vector<SplIrInstructionList::iterator> flattened;
+
+    void count_uses(const std::shared_ptr<SplIrInstruction> &inst, int delta) {
+        for (auto use : inst->uses()) {
+            use_count[use->get()] += delta;
+        }
+    }
+
+    // a definition read only here is flattened as well if it is in the same
+    // basic block, its operands are read at another place, so only constants
+    // and ssa values may be leaves then
+    bool add_operand(const std::shared_ptr<SplIrOperand> &op, int coefficient,
+                     SplIrLinearForm &form, bool at_root,
+                     const std::shared_ptr<SplIrBasicBlock> &basic_block) {
+        int constant;
+        if (spl_ir_get_constant(op, constant)) {
+            form.add_constant(spl_ir_multiply(coefficient, constant));
+            return true;
+        }
+        if (!is_ssa_value(ir_module, op)) {
+            form.add_term(op, coefficient);
+            return at_root;
+        }
+        auto it = definitions.find(op.get());
+        if (it != definitions.end() && use_count[op.get()] == 1 &&
+            (*it->second)->parent == basic_block) {
+            auto expanded = form;
+            auto size = flattened.size();
+            flattened.push_back(it->second);
+            if (flatten(*it->second, coefficient, expanded, false)) {
+                form = expanded;
+                return true;
+            }
+            flattened.resize(size);
+        }
+        form.add_term(op, coefficient);
+        return true;
+    }
+
+    // returns false if the instruction is not linear
+    bool flatten(const std::shared_ptr<SplIrInstruction> &inst,
+                 int coefficient, SplIrLinearForm &form, bool at_root) {
+        auto uses = inst->uses();
+        auto &basic_block = inst->parent;
+        int constant;
+        switch (inst->type) {
+        case SplIrInstructionType::ASSIGN:
+            return add_operand(*uses[0], coefficient, form, at_root,
+                               basic_block);
+        case SplIrInstructionType::ASSIGN_ADD:
+            return add_operand(*uses[0], coefficient, form, at_root,
+                               basic_block) &&
+                   add_operand(*uses[1], coefficient, form, at_root,
+                               basic_block);
+        case SplIrInstructionType::ASSIGN_MINUS:
+            return add_operand(*uses[0], coefficient, form, at_root,
+                               basic_block) &&
+                   add_operand(*uses[1], spl_ir_multiply(coefficient, -1),
+                               form, at_root, basic_block);
+        case SplIrInstructionType::ASSIGN_MUL:
+            if (spl_ir_get_constant(*uses[0], constant)) {
+                return add_operand(*uses[1],
+                                   spl_ir_multiply(coefficient, constant),
+                                   form, at_root, basic_block);
+            }
+            if (spl_ir_get_constant(*uses[1], constant)) {
+                return add_operand(*uses[0],
+                                   spl_ir_multiply(coefficient, constant),
+                                   form, at_root, basic_block);
+            }
+            return false;
+        case SplIrInstructionType::ASSIGN_DIV:
+            if (spl_ir_get_constant(*uses[1], constant) &&
+                (constant == 1 || constant == -1)) {
+                return add_operand(*uses[0],
+                                   spl_ir_multiply(coefficient, constant),
+                                   form, at_root, basic_block);
+            }
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    // constants go to the right of commutative operators
+    bool canonicalize(SplIrInstructionList::iterator it) {
+        auto &inst = *it;
+        if (inst->type != SplIrInstructionType::ASSIGN_ADD &&
+            inst->type != SplIrInstructionType::ASSIGN_MUL) {
+            return false;
+        }
+        auto uses = inst->uses();
+        if ((*uses[0])->type != SplIrOperandType::R_VALUE_CONSTANT ||
+            (*uses[1])->type == SplIrOperandType::R_VALUE_CONSTANT) {
+            return false;
+        }
+        ir_module.replace_instruction(
+            it, spl_ir_make_arithmetic(inst->type, *inst->def(), *uses[1],
+                                       *uses[0]));
+        return true;
+    }
+
+    bool simplify(SplIrInstructionList::iterator it) {
+        auto inst = *it;
+        auto dst = *inst->def();
+        SplIrLinearForm form;
+        flattened.clear();
+        if (!flatten(inst, 1, form, true)) {
+            return canonicalize(it);
+        }
+        // copies are mostly coalesced away, so they count as free
+        size_t cost = spl_ir_is_arithmetic(inst->type);
+        for (auto it_flattened : flattened) {
+            cost += spl_ir_is_arithmetic((*it_flattened)->type);
+        }
+        size_t new_cost = spl_ir_count_instructions(form);
+        if (new_cost > cost ||
+            (new_cost == cost &&
+             std::max<size_t>(new_cost, 1) >= flattened.size() + 1)) {
+            return canonicalize(it);
+        }
+        for (auto it_flattened : flattened) {
+            count_uses(*it_flattened, -1);
+            definitions.erase((*it_flattened)->def()->get());
+            ir_module.erase_instruction_in_place(it_flattened);
+        }
+        count_uses(inst, -1);
+        auto emitted = spl_ir_emit_linear_form(ir_module, form, dst);
+        for (size_t i = 0; i + 1 < emitted.size(); i++) {
+            auto it_emitted =
+                ir_module.insert_instruction(it, emitted[i], inst->parent);
+            definitions[emitted[i]->def()->get()] = it_emitted;
+        }
+        ir_module.replace_instruction(it, emitted.back());
+        for (auto &inst_emitted : emitted) {
+            count_uses(inst_emitted, 1);
+        }
+        return true;
+    }
+
+  public:
+    SplIrAlgebraicSimplifier(SplIrModule &ir_module,
+                             const SplIrFunction &function)
+        : ir_module(ir_module), function(function) {}
+
+    bool run() {
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                auto &inst = *it;
+                auto def = inst->def();
+                if (def != nullptr && is_ssa_value(ir_module, *def) &&
+                    (inst->type == SplIrInstructionType::ASSIGN ||
+                     spl_ir_is_arithmetic(inst->type))) {
+                    definitions[def->get()] = it;
+                }
+                count_uses(inst, 1);
+            }
+        }
+        bool changed = false;
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                if (spl_ir_is_arithmetic((*it)->type)) {
+                    changed |= simplify(it);
+                }
+            }
+        }
+        return changed;
+    }
+};
+
+bool simplify_algebra(SplIrModule &ir_module) {
+    bool changed = false;
+    for (auto &function : ir_module.analyses().get_functions()) {
+        SplIrAlgebraicSimplifier simplifier(ir_module, *function);
+        changed |= simplifier.run();
+    }
+    if (changed) {
+        ir_module.rebuild_use_lists();
+    }
+    return changed;
+}
+
+class SplIrValueNumbering {
+  private:
+    SplIrModule &ir_module;
+    const SplIrFunction &function;
+    const SplIrDominatorTree &dom;
+    const SplIrFunctionSummaries &summaries;
+    // operands proved equal to an earlier one, which dominates them
+    std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>> leader;
+    // expressions computed on the path from the entry in the dominator tree
+    std::unordered_map<std::string, std::shared_ptr<SplIrOperand>> available;
+    std::vector<SplIrInstructionList::iterator> redundant;
+
+    std::shared_ptr<SplIrOperand> find(std::shared_ptr<SplIrOperand> op) {
+        for (auto it = leader.find(op.get()); it != leader.end();
+             it = leader.find(op.get())) {
+            op = it->second;
+        }
+        return op;
+    }
+
+    bool is_value_number(const std::shared_ptr<SplIrOperand> &op) {
+        return op->type == SplIrOperandType::R_VALUE_CONSTANT ||
+               is_ssa_value(ir_module, op);
+    }
+
+    // phi instructions merging a single value are that value, otherwise
+    // phi instructions of the same basic block with equal incoming values
+    // are equal
+    void get_phi_key(const std::shared_ptr<SplIrPhiInstruction> &phi,
+                     std::string &key, std::shared_ptr<SplIrOperand> &same) {
+        key = "phi " + phi->parent->name;
+        same = nullptr;
+        bool unique = true;
+        for (auto &incoming : phi->incomings) {
+            auto value = find(incoming.second);
+            key += " " + incoming.first->name + " " + value->repr;
+            if (value == phi->dst) {
+                continue;
+            }
+            if (same != nullptr && same != value) {
+                unique = false;
+            }
+            same = value;
+        }
+        if (!unique) {
+            same = nullptr;
+        }
+    }
+
+    // pure computations on value numbers, keyed by the operator and operand
+    // value numbers, commutative operands are sorted
+    bool get_key(SplIrInstructionList::iterator it, std::string &key) {
+        auto &inst = *it;
+        if (inst->type == SplIrInstructionType::ASSIGN_CALL) {
+            auto &func =
+                std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                    ->func;
+            if (!summaries.get_summary(func->repr).is_pure()) {
+                return false;
+            }
+            key = "call " + func->repr;
+            for (auto it_arg : spl_ir_get_call_args(ir_module, it)) {
+                auto arg = find(
+                    std::static_pointer_cast<SplIrArgInstruction>(*it_arg)
+                        ->arg);
+                if (!is_value_number(arg)) {
+                    return false;
+                }
+                key += " " + arg->repr;
+            }
+            return true;
+        }
+        if (inst->type == SplIrInstructionType::ASSIGN_ADDRESS) {
+            // the address of a local is fixed in one call
+            auto inst_address =
+                std::static_pointer_cast<SplIrAssignAddressInstruction>(inst);
+            key = "& " + inst_address->src->repr;
+            return true;
+        }
+        if (!spl_ir_is_arithmetic(inst->type)) {
+            return false;
+        }
+        auto uses = inst->uses();
+        auto lhs = find(*uses[0]), rhs = find(*uses[1]);
+        if (!is_value_number(lhs) || !is_value_number(rhs)) {
+            return false;
+        }
+        if ((inst->type == SplIrInstructionType::ASSIGN_ADD ||
+             inst->type == SplIrInstructionType::ASSIGN_MUL) &&
+            rhs->repr < lhs->repr) {
+            std::swap(lhs, rhs);
+        }
+        key = std::to_string(static_cast<int>(inst->type)) + " " + lhs->repr +
+              " " + rhs->repr;
+        return true;
+    }
+
+    void visit(const std::shared_ptr<SplIrBasicBlock> &basic_block) {
+        std::vector<std::string> inserted;
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            auto &inst = *it;
+            auto def = inst->def();
+            if (def == nullptr || !is_ssa_value(ir_module, *def)) {
+                continue;
+            }
+            std::string key;
+            std::shared_ptr<SplIrOperand> same = nullptr;
+            if (inst->type == SplIrInstructionType::PHI) {
+                get_phi_key(std::static_pointer_cast<SplIrPhiInstruction>(inst),
+                            key, same);
+            } else if (!get_key(it, key)) {
+                continue;
+            }
+            if (same == nullptr && !key.empty()) {
+                auto it_available = available.find(key);
+                if (it_available != available.end()) {
+                    same = it_available->second;
+                } else {
+                    available.emplace(key, *def);
+                    inserted.push_back(key);
+                }
+            }
+            if (same != nullptr) {
+                leader[def->get()] = same;
+                redundant.push_back(it);
+            }
+        }
+        for (auto &child : dom.get_children(basic_block)) {
+            visit(child);
+        }
+        for (auto &key : inserted) {
+            available.erase(key);
+        }
+    }
+
+  public:
+    SplIrValueNumbering(SplIrModule &ir_module, const SplIrFunction &function,
+                        const SplIrDominatorTree &dom,
+                        const SplIrFunctionSummaries &summaries)
+        : ir_module(ir_module), function(function), dom(dom),
+          summaries(summaries) {}
+
+    bool run() {
+        if (function.basic_blocks.empty()) {
+            return false;
+        }
+        visit(function.basic_blocks.front());
+        if (redundant.empty()) {
+            return false;
+        }
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                for (auto use : (*it)->uses()) {
+                    *use = find(*use);
+                }
+            }
+        }
+        for (auto it : redundant) {
+            if ((*it)->type == SplIrInstructionType::ASSIGN_CALL) {
+                spl_ir_erase_call(ir_module, it, find(*(*it)->def()));
+            } else {
+                spl_ir_erase_definition(ir_module, it);
+            }
+        }
+        return true;
+    }
+};
+
+bool number_values(SplIrModule &ir_module) {
+    bool changed = false;
+    auto &manager = ir_module.analyses();
+    for (auto &function : manager.get_functions()) {
+        SplIrValueNumbering numbering(
+            ir_module, *function, manager.get_dominator_tree(function->name),
+            manager.get_function_summaries());
+        changed |= numbering.run();
+    }
+    if (changed) {
+        ir_module.rebuild_use_lists();
+    }
+    return changed;
+}
+
+// definitions without side effects are live only if a live instruction reads
+// them, all the others are live from the start (mark and sweep, so dead
+// cycles through phi instructions go as well)
+class SplIrDeadCodeElimination {
+  private:
+    SplIrModule &ir_module;
+    const SplIrFunction &function;
+    const SplIrFunctionSummaries &summaries;
+    std::unordered_map<SplIrOperand *, SplIrInstructionList::iterator>
+        definitions;
+    std::unordered_set<SplIrInstruction *> live;
+    std::vector<SplIrInstructionList::iterator> worklist;
+    // arguments of removable calls, live along with their calls
+    std::unordered_set<SplIrInstruction *> removable_args;
+
+    bool is_removable(const std::shared_ptr<SplIrInstruction> &inst) {
+        auto def = inst->def();
+        if (def == nullptr || !is_ssa_value(ir_module, *def)) {
+            return false;
+        }
+        switch (inst->type) {
+        case SplIrInstructionType::ASSIGN:
+        case SplIrInstructionType::ASSIGN_ADD:
+        case SplIrInstructionType::ASSIGN_MINUS:
+        case SplIrInstructionType::ASSIGN_MUL:
+        case SplIrInstructionType::ASSIGN_DIV:
+        case SplIrInstructionType::ASSIGN_ADDRESS:
+        case SplIrInstructionType::ASSIGN_DEREF_SRC:
+        case SplIrInstructionType::PHI:
+            return true;
+        case SplIrInstructionType::ASSIGN_CALL:
+            return summaries
+                .get_summary(
+                    std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                        ->func->repr)
+                .is_side_effect_free();
+        default:
+            return false;
+        }
+    }
+
+    void mark(SplIrInstructionList::iterator it) {
+        if (live.insert(it->get()).second) {
+            worklist.push_back(it);
+        }
+    }
+
+  public:
+    SplIrDeadCodeElimination(SplIrModule &ir_module,
+                             const SplIrFunction &function,
+                             const SplIrFunctionSummaries &summaries)
+        : ir_module(ir_module), function(function), summaries(summaries) {}
+
+    bool run() {
+        std::vector<SplIrInstructionList::iterator> instructions;
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                instructions.push_back(it);
+                auto def = (*it)->def();
+                if (def != nullptr && is_ssa_value(ir_module, *def)) {
+                    definitions[def->get()] = it;
+                }
+                if ((*it)->type == SplIrInstructionType::ASSIGN_CALL &&
+                    is_removable(*it)) {
+                    for (auto it_arg : spl_ir_get_call_args(ir_module, it)) {
+                        removable_args.insert(it_arg->get());
+                    }
+                }
+            }
+        }
+        for (auto it : instructions) {
+            if (!is_removable(*it) &&
+                (*it)->type != SplIrInstructionType::DEC &&
+                removable_args.count(it->get()) == 0) {
+                mark(it);
+            }
+        }
+        // memory is declared as long as its address is taken
+        std::unordered_set<SplIrOperand *> referenced_memory;
+        while (!worklist.empty()) {
+            auto it = worklist.back();
+            worklist.pop_back();
+            if ((*it)->type == SplIrInstructionType::ASSIGN_ADDRESS) {
+                referenced_memory.insert(
+                    std::static_pointer_cast<SplIrAssignAddressInstruction>(*it)
+                        ->src.get());
+            } else if ((*it)->type == SplIrInstructionType::ASSIGN_CALL) {
+                for (auto it_arg : spl_ir_get_call_args(ir_module, it)) {
+                    mark(it_arg);
+                }
+            }
+            for (auto use : (*it)->uses()) {
+                auto it_def = definitions.find(use->get());
+                if (it_def != definitions.end()) {
+                    mark(it_def->second);
+                }
+            }
+        }
+        bool changed = false;
+        for (auto it : instructions) {
+            // arguments go along with their calls
+            if (live.count(it->get()) > 0 ||
+                (*it)->type == SplIrInstructionType::ARG) {
+                continue;
+            }
+            if ((*it)->type == SplIrInstructionType::ASSIGN_CALL) {
+                spl_ir_erase_call(ir_module, it,
+                                  spl_ir_make_constant(ir_module, 0));
+                changed = true;
+                continue;
+            }
+            if ((*it)->type == SplIrInstructionType::DEC &&
+                referenced_memory.count(
+                    std::static_pointer_cast<SplIrDecInstruction>(*it)
+                        ->variable.get()) > 0) {
+                continue;
+            }
+            changed |= spl_ir_erase_definition(ir_module, it);
+        }
+        return changed;
+    }
+};
+
+bool eliminate_dead_code(SplIrModule &ir_module) {
+    bool changed = false;
+    auto &manager = ir_module.analyses();
+    for (auto &function : manager.get_functions()) {
+        SplIrDeadCodeElimination elimination(
+            ir_module, *function, manager.get_function_summaries());
+        changed |= elimination.run();
+    }
+    if (changed) {
+        ir_module.rebuild_use_lists();
+    }
+    return changed;
+}
+
+class SplIrMemoryOptimization {
+  private:
+    // a value known to be in memory at an address, left by a load or a store
+    struct SplIrMemoryValue {
+        // the operand holding the address
+        std::shared_ptr<SplIrOperand> pointer;
+        std::shared_ptr<SplIrOperand> value;
+        // the store, if any, along with whether the value has been read since
+        std::optional<SplIrInstructionList::iterator> store;
+        bool read = false;
+    };
+
+    SplIrModule &ir_module;
+    const SplIrFunction &function;
+    const SplIrAliasAnalysis &alias;
+    const SplIrFunctionSummaries &summaries;
+    std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>> replaced;
+    std::vector<SplIrInstructionList::iterator> erased;
+
+    std::shared_ptr<SplIrOperand> find(std::shared_ptr<SplIrOperand> op) {
+        for (auto it = replaced.find(op.get()); it != replaced.end();
+             it = replaced.find(op.get())) {
+            op = it->second;
+        }
+        return op;
+    }
+
+    void run_on_basic_block(const std::shared_ptr<SplIrBasicBlock> &block) {
+        std::vector<SplIrMemoryValue> known;
+        for (auto it = block->head;
+             it != ir_module.ir.end() && (*it)->parent == block; it++) {
+            auto &inst = *it;
+            if (inst->type == SplIrInstructionType::ASSIGN_DEREF_SRC) {
+                auto inst_deref =
+                    std::static_pointer_cast<SplIrAssignDerefSrcInstruction>(
+                        inst);
+                auto same = std::find_if(
+                    known.begin(), known.end(), [&](const auto &value) {
+                        return alias.must_alias(value.pointer, inst_deref->src);
+                    });
+                if (same != known.end() &&
+                    is_ssa_value(ir_module, inst_deref->dst)) {
+                    same->read = true;
+                    replaced[inst_deref->dst.get()] = find(same->value);
+                    erased.push_back(it);
+                    continue;
+                }
+                for (auto &value : known) {
+                    value.read |=
+                        alias.may_alias(value.pointer, inst_deref->src);
+                }
+                if (is_ssa_value(ir_module, inst_deref->dst)) {
+                    known.push_back({inst_deref->src, inst_deref->dst,
+                                     std::nullopt, false});
+                }
+            } else if (inst->type == SplIrInstructionType::ASSIGN_DEREF_DST) {
+                auto inst_deref =
+                    std::static_pointer_cast<SplIrAssignDerefDstInstruction>(
+                        inst);
+                std::vector<SplIrMemoryValue> kept;
+                for (auto &value : known) {
+                    if (value.store.has_value() && !value.read &&
+                        alias.must_alias(value.pointer, inst_deref->dst)) {
+                        erased.push_back(value.store.value());
+                    } else if (!alias.may_alias(value.pointer,
+                                                inst_deref->dst)) {
+                        kept.push_back(value);
+                    }
+                }
+                known = kept;
+                // values redefined outside ssa form are not forwarded
+                auto stored = find(inst_deref->src);
+                if (stored->type == SplIrOperandType::R_VALUE_CONSTANT ||
+                    is_ssa_value(ir_module, stored)) {
+                    known.push_back({inst_deref->dst, stored, it, false});
+                }
+            } else if (inst->type == SplIrInstructionType::ASSIGN_CALL) {
+                // callees only reach memory whose address escapes
+                auto summary = summaries.get_summary(
+                    std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                        ->func->repr);
+                if (summary.is_pure()) {
+                    continue;
+                }
+                std::vector<SplIrMemoryValue> kept;
+                for (auto &value : known) {
+                    if (alias.is_private(alias.get_address(value.pointer))) {
+                        kept.push_back(value);
+                    } else if (!summary.writes_memory) {
+                        value.read = true;
+                        kept.push_back(value);
+                    }
+                }
+                known = kept;
+            }
+        }
+    }
+
+    // stores to declared memory no load reads and no callee reaches
+    void remove_unread_stores() {
+        std::unordered_set<size_t> loaded;
+        std::vector<SplIrInstructionList::iterator> stores;
+        std::unordered_set<SplIrInstruction *> gone;
+        for (auto it : erased) {
+            gone.insert(it->get());
+        }
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                if (gone.count(it->get()) > 0) {
+                    continue;
+                }
+                if ((*it)->type == SplIrInstructionType::ASSIGN_DEREF_SRC) {
+                    auto address = alias.get_address(
+                        std::static_pointer_cast<
+                            SplIrAssignDerefSrcInstruction>(*it)
+                            ->src);
+                    if (address.kind == SplIrAddress::MEMORY) {
+                        loaded.insert(address.base);
+                    }
+                } else if ((*it)->type ==
+                           SplIrInstructionType::ASSIGN_DEREF_DST) {
+                    stores.push_back(it);
+                }
+            }
+        }
+        for (auto it : stores) {
+            auto address = alias.get_address(
+                std::static_pointer_cast<SplIrAssignDerefDstInstruction>(*it)
+                    ->dst);
+            if (alias.is_private(address) && loaded.count(address.base) == 0) {
+                erased.push_back(it);
+            }
+        }
+    }
+
+  public:
+    SplIrMemoryOptimization(SplIrModule &ir_module,
+                            const SplIrFunction &function,
+                            const SplIrAliasAnalysis &alias,
+                            const SplIrFunctionSummaries &summaries)
+        : ir_module(ir_module), function(function), alias(alias),
+          summaries(summaries) {}
+
+    bool run() {
+        // direct accesses to a variable are not tracked
+        if (alias.variable_address_taken) {
+            return false;
+        }
+        for (auto &basic_block : function.basic_blocks) {
+            run_on_basic_block(basic_block);
+        }
+        remove_unread_stores();
+        if (erased.empty()) {
+            return false;
+        }
+        for (auto &basic_block : function.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                for (auto use : (*it)->uses()) {
+                    *use = find(*use);
+                }
+            }
+        }
+        // a load left as the only instruction of its basic block is dead
+        // code, a store is kept
+        std::unordered_set<SplIrInstruction *> done;
+        bool changed = !replaced.empty();
+        for (auto it : erased) {
+            if (done.insert(it->get()).second) {
+                changed |= ir_module.erase_instruction_in_place(it);
+            }
+        }
+        return changed;
+    }
+};
+
+bool optimize_memory_accesses(SplIrModule &ir_module) {
+    bool changed = false;
+    auto &manager = ir_module.analyses();
+    for (auto &function : manager.get_functions()) {
+        SplIrMemoryOptimization optimization(
+            ir_module, *function, manager.get_alias_analysis(function->name),
+            manager.get_function_summaries());
+        changed |= optimization.run();
+    }
+    if (changed) {
+        ir_module.rebuild_use_lists();
+    }
+    return changed;
+}
+
+bool replace_aggregates(SplIrModule &ir_module) {
+    auto &manager = ir_module.analyses();
+    SplIrOperandSet scalars;
+    for (auto &function : manager.get_functions()) {
+        auto &alias = manager.get_alias_analysis(function->name);
+        if (alias.variable_address_taken) {
+            continue;
+        }
+        // size of each declared memory, and loads and stores into one
+        std::unordered_map<size_t, int> sizes;
+        std::unordered_set<size_t> rejected;
+        std::vector<std::pair<SplIrInstructionList::iterator, SplIrAddress>>
+            accesses;
+        for (auto &basic_block : function->basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                std::shared_ptr<SplIrOperand> pointer;
+                if ((*it)->type == SplIrInstructionType::DEC) {
+                    auto inst_dec =
+                        std::static_pointer_cast<SplIrDecInstruction>(*it);
+                    auto base = alias.base_index.find(inst_dec->variable->repr);
+                    if (base != alias.base_index.end()) {
+                        sizes[base->second] = inst_dec->size;
+                    }
+                    continue;
+                } else if ((*it)->type ==
+                           SplIrInstructionType::ASSIGN_DEREF_SRC) {
+                    pointer = std::static_pointer_cast<
+                                  SplIrAssignDerefSrcInstruction>(*it)
+                                  ->src;
+                } else if ((*it)->type ==
+                           SplIrInstructionType::ASSIGN_DEREF_DST) {
+                    pointer = std::static_pointer_cast<
+                                  SplIrAssignDerefDstInstruction>(*it)
+                                  ->dst;
+                } else {
+                    continue;
+                }
+                auto address = alias.get_address(pointer);
+                if (address.kind != SplIrAddress::MEMORY) {
+                    continue;
+                }
+                if (!address.offset_known || address.symbol != nullptr ||
+                    address.offset < 0 || address.offset % 4 != 0) {
+                    rejected.insert(address.base);
+                }
+                accesses.emplace_back(it, address);
+            }
+        }
+        // accesses out of bounds are left to behave as they do
+        for (auto &[it, address] : accesses) {
+            auto size = sizes.find(address.base);
+            if (size == sizes.end() || address.offset >= size->second) {
+                rejected.insert(address.base);
+            }
+        }
+        std::map<std::pair<size_t, int>, std::shared_ptr<SplIrOperand>> words;
+        for (auto &[it, address] : accesses) {
+            if (rejected.count(address.base) > 0 ||
+                alias.escaped[address.base] ||
+                sizes.at(address.base) > SPL_IR_SCALAR_REPLACEMENT_THRESHOLD) {
+                continue;
+            }
+            auto &word = words[{address.base, address.offset}];
+            if (word == nullptr) {
+                word = ir_module.var_counter->next();
+                scalars.insert(word);
+            }
+            if ((*it)->type == SplIrInstructionType::ASSIGN_DEREF_SRC) {
+                ir_module.replace_instruction(
+                    it, std::make_shared<SplIrAssignInstruction>(
+                            std::static_pointer_cast<
+                                SplIrAssignDerefSrcInstruction>(*it)
+                                ->dst,
+                            word));
+            } else {
+                ir_module.replace_instruction(
+                    it, std::make_shared<SplIrAssignInstruction>(
+                            word, std::static_pointer_cast<
+                                      SplIrAssignDerefDstInstruction>(*it)
+                                      ->src));
+            }
+        }
+    }
+    if (scalars.empty()) {
+        return false;
+    }
+    // addresses no longer used are left to dead code elimination, the
+    // declared memory goes along with them
+    promote_to_ssa(ir_module, scalars);
+    return true;
+}
+
+bool insert_loop_preheaders(SplIrModule &ir_module) {
+    auto &manager = ir_module.analyses();
+    std::vector<std::pair<std::shared_ptr<SplIrBasicBlock>,
+                          SplIrBasicBlockVector>>
+        headers;
+    for (auto &function : manager.get_functions()) {
+        for (auto &loop : manager.get_natural_loops(function->name).loops) {
+            auto &header = loop->header;
+            if ((*header->head)->type != SplIrInstructionType::LABEL) {
+                continue;
+            }
+            SplIrBasicBlockVector entries;
+            for (auto &pred : header->predecessors) {
+                if (!loop->contains(pred) &&
+                    std::find(entries.begin(), entries.end(), pred) ==
+                        entries.end()) {
+                    entries.push_back(pred);
+                }
+            }
+            if (entries.size() == 1 && entries[0]->successors.size() == 1) {
+                continue;
+            }
+            // a back edge falling through to the header would enter the
+            // preheader as well
+            bool latch_falls_through = false;
+            for (auto &latch : loop->latches) {
+                auto end = ir_module.get_basic_block_end(latch);
+                auto last = (*std::prev(end))->type;
+                latch_falls_through |= end == header->head &&
+                                       last != SplIrInstructionType::GOTO;
+            }
+            if (!latch_falls_through) {
+                headers.emplace_back(header, entries);
+            }
+        }
+    }
+    for (auto &[header, entries] : headers) {
+        auto header_label =
+            std::static_pointer_cast<SplIrLabelInstruction>(*header->head)
+                ->label;
+        auto label = ir_module.label_counter->next();
+        ir_module.ir.insert(header->head,
+                            std::make_shared<SplIrLabelInstruction>(label));
+        // entries falling through to the header reach the new label first
+        for (auto &entry : entries) {
+            auto &last = *std::prev(ir_module.get_basic_block_end(entry));
+            if (last->type == SplIrInstructionType::GOTO ||
+                last->type == SplIrInstructionType::IF_GOTO) {
+                ir_module.replace_usage(last, header_label, label);
+            }
+        }
+    }
+    if (headers.empty()) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+// the test of a while loop is copied to the end of its body, where it jumps
+// back to the body while the loop goes on and falls through to the exit
+// otherwise, the original test is left to guard the entry
+bool rotate_loops(SplIrModule &ir_module) {
+    // copies of longer tests cost more than the jump they save
+    const size_t max_test_size = 6;
+    auto &manager = ir_module.analyses();
+    // header, body and the back edge of each loop to rotate
+    std::vector<std::tuple<std::shared_ptr<SplIrBasicBlock>,
+                           std::shared_ptr<SplIrBasicBlock>,
+                           SplIrInstructionList::iterator>>
+        rotations;
+    for (auto &function : manager.get_functions()) {
+        for (auto &loop : manager.get_natural_loops(function->name).loops) {
+            auto &header = loop->header;
+            if ((*header->head)->type != SplIrInstructionType::LABEL ||
+                loop->latches.size() != 1 || loop->latches[0] == header) {
+                continue;
+            }
+            auto header_end = ir_module.get_basic_block_end(header);
+            auto latch_end = ir_module.get_basic_block_end(loop->latches[0]);
+            auto branch = *std::prev(header_end);
+            auto back_edge = std::prev(latch_end);
+            if (branch->type != SplIrInstructionType::IF_GOTO ||
+                (*back_edge)->type != SplIrInstructionType::GOTO ||
+                header_end == ir_module.ir.end() ||
+                latch_end == ir_module.ir.end() ||
+                (*latch_end)->type != SplIrInstructionType::LABEL ||
+                std::distance(header->head, header_end) >
+                    (std::ptrdiff_t)max_test_size + 1) {
+                continue;
+            }
+            // the test falls through to the body and jumps to the exit, which
+            // comes right after the back edge
+            auto label =
+                std::static_pointer_cast<SplIrIfGotoInstruction>(branch)
+                    ->label.value();
+            auto body = (*header_end)->parent;
+            if (!loop->contains(body) ||
+                loop->contains(spl_ir_get_jump_target(header, label)) ||
+                std::static_pointer_cast<SplIrLabelInstruction>(*latch_end)
+                        ->label != label) {
+                continue;
+            }
+            rotations.emplace_back(header, body, back_edge);
+        }
+    }
+    for (auto &[header, body, back_edge] : rotations) {
+        if ((*body->head)->type != SplIrInstructionType::LABEL) {
+            ir_module.ir.insert(body->head,
+                                std::make_shared<SplIrLabelInstruction>(
+                                    ir_module.label_counter->next()));
+            body->head--;
+        }
+        auto body_label =
+            std::static_pointer_cast<SplIrLabelInstruction>(*body->head)
+                ->label;
+        // temporaries only living in the test get fresh ones in the copy
+        std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>>
+            renamed;
+        auto header_end = ir_module.get_basic_block_end(header);
+        for (auto it = std::next(header->head); it != header_end; it++) {
+            auto def = (*it)->def();
+            if (def == nullptr || (*def)->type !=
+                                      SplIrOperandType::L_VALUE_TEMPORARY) {
+                continue;
+            }
+            bool local = true;
+            for (auto &inst : ir_module.use_lists[(*def)->repr]) {
+                local &= inst->parent == header;
+            }
+            if (local) {
+                renamed[def->get()] = ir_module.tmp_counter->next();
+            }
+        }
+        for (auto it = std::next(header->head); it != header_end; it++) {
+            std::shared_ptr<SplIrInstruction> inst;
+            if ((*it)->type == SplIrInstructionType::IF_GOTO) {
+                auto inst_if_goto =
+                    std::static_pointer_cast<SplIrIfGotoInstruction>(*it);
+                auto inst_copy = std::make_shared<SplIrIfGotoInstruction>(
+                    inst_if_goto->lhs, inst_if_goto->rhs,
+                    SplIrIfGotoInstruction::negated_relop(
+                        inst_if_goto->relop));
+                inst_copy->patch(body_label);
+                inst = inst_copy;
+            } else {
+                inst = spl_ir_clone_instruction(*it);
+            }
+            for (auto &operand : inst->operands) {
+                auto it_renamed = renamed.find(operand.get().get());
+                if (it_renamed != renamed.end()) {
+                    operand.get() = it_renamed->second;
+                }
+            }
+            ir_module.ir.insert(back_edge, inst);
+        }
+        ir_module.ir.erase(back_edge);
+    }
+    if (rotations.empty()) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+bool merge_adjacent_labels(SplIrModule &ir_module) {
+    bool changed = false;
+    std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>> merged;
+    for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+        auto current = it++;
+        if (it == ir_module.ir.end() ||
+            (*current)->type != SplIrInstructionType::LABEL ||
+            (*it)->type != SplIrInstructionType::LABEL) {
+            continue;
+        }
+        merged[std::static_pointer_cast<SplIrLabelInstruction>(*current)
+                   ->label.get()] =
+            std::static_pointer_cast<SplIrLabelInstruction>(*it)->label;
+        ir_module.erase_instruction(current);
+        changed = true;
+    }
+    if (!changed) {
+        return false;
+    }
+    for (auto &inst : ir_module.ir) {
+        for (auto operand : inst->operands) {
+            auto label = operand.get();
+            for (auto it = merged.find(label.get()); it != merged.end();
+                 it = merged.find(label.get())) {
+                label = it->second;
+            }
+            if (label != operand.get()) {
+                ir_module.replace_usage(inst, operand.get(), label);
+            }
+        }
+    }
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+// the only basic block entering the loop, if it falls or jumps to the header
+// and nowhere else
+std::shared_ptr<SplIrBasicBlock> spl_ir_get_preheader(const SplIrLoop &loop) {
+    std::shared_ptr<SplIrBasicBlock> preheader = nullptr;
+    for (auto &pred : loop.header->predecessors) {
+        if (loop.contains(pred)) {
+            continue;
+        }
+        if (preheader != nullptr || pred->successors.size() != 1) {
+            return nullptr;
+        }
+        preheader = pred;
+    }
+    return preheader;
+}
+
+// where computations are appended to the preheader, before the jump to the
+// header if there is one
+SplIrInstructionList::iterator
+spl_ir_get_preheader_end(SplIrModule &ir_module,
+                         const std::shared_ptr<SplIrBasicBlock> &preheader) {
+    auto pos = ir_module.get_basic_block_end(preheader);
+    if ((*std::prev(pos))->type == SplIrInstructionType::GOTO) {
+        pos--;
+    }
+    return pos;
+}
+
+// loop invariant code motion on ssa form, pure computations whose operands
+// are constants or defined outside the loop move to the preheader, inner
+// loops go first so that computations move out of a whole loop nest
+class SplIrLoopInvariantCodeMotion {
+  private:
+    SplIrModule &ir_module;
+    const SplIrLoopInfo &loops;
+
+    // division by zero must not be made to happen when the loop would not
+    // execute it
+    static bool is_hoistable(const std::shared_ptr<SplIrInstruction> &inst) {
+        int divisor;
+        switch (inst->type) {
+        case SplIrInstructionType::ASSIGN:
+        case SplIrInstructionType::ASSIGN_ADD:
+        case SplIrInstructionType::ASSIGN_MINUS:
+        case SplIrInstructionType::ASSIGN_MUL:
+        case SplIrInstructionType::ASSIGN_ADDRESS:
+            return true;
+        case SplIrInstructionType::ASSIGN_DIV:
+            return spl_ir_get_constant(*inst->uses()[1], divisor) &&
+                   divisor != 0;
+        default:
+            return false;
+        }
+    }
+
+    bool hoist(const SplIrLoop &loop) {
+        auto preheader = spl_ir_get_preheader(loop);
+        if (preheader == nullptr) {
+            return false;
+        }
+        std::unordered_set<SplIrOperand *> defined_in_loop;
+        for (auto &basic_block : loop.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                if (auto def = (*it)->def()) {
+                    defined_in_loop.insert(def->get());
+                }
+            }
+        }
+        auto is_invariant = [&](const std::shared_ptr<SplIrOperand> &op) {
+            return op->type == SplIrOperandType::R_VALUE_CONSTANT ||
+                   (is_ssa_value(ir_module, op) &&
+                    defined_in_loop.count(op.get()) == 0);
+        };
+        auto pos = spl_ir_get_preheader_end(ir_module, preheader);
+        bool changed = false, hoisted = true;
+        while (hoisted) {
+            hoisted = false;
+            for (auto &basic_block : loop.basic_blocks) {
+                for (auto it = basic_block->head;
+                     it != ir_module.ir.end() &&
+                     (*it)->parent == basic_block;) {
+                    auto current = it++;
+                    auto inst = *current;
+                    auto def = inst->def();
+                    if (!is_hoistable(inst) ||
+                        !is_ssa_value(ir_module, *def)) {
+                        continue;
+                    }
+                    bool invariant = true;
+                    for (auto use : inst->uses()) {
+                        invariant &= is_invariant(*use);
+                    }
+                    if (!invariant ||
+                        !ir_module.erase_instruction_in_place(current)) {
+                        continue;
+                    }
+                    ir_module.insert_instruction(pos, inst, preheader);
+                    defined_in_loop.erase(def->get());
+                    changed = hoisted = true;
+                }
+            }
+        }
+        return changed;
+    }
+
+  public:
+    SplIrLoopInvariantCodeMotion(SplIrModule &ir_module,
+                                 const SplIrLoopInfo &loops)
+        : ir_module(ir_module), loops(loops) {}
+
+    bool run() {
+        bool changed = false;
+        for (auto &loop : loops.loops) {
+            changed |= hoist(*loop);
+        }
+        return changed;
+    }
+};
+
+bool hoist_loop_invariants(SplIrModule &ir_module) {
+    bool changed = false;
+    auto &manager = ir_module.analyses();
+    for (auto &function : manager.get_functions()) {
+        SplIrLoopInvariantCodeMotion motion(
+            ir_module, manager.get_natural_loops(function->name));
+        changed |= motion.run();
+    }
+    return changed;
+}
+
+// value of basic * scale + base + offset, where basic is a basic induction
+// variable and the terms of base are loop invariant, as in the address
+// base + (i * d + j) * 4 of an element of a two dimensional array
+struct SplIrInductionVariable {
+    std::shared_ptr<SplIrOperand> basic;
+    int scale = 1;
+    SplIrLinearForm base;
+    int offset = 0;
+};
+
+// a phi instruction of the header whose value on the back edge is its own
+// plus a constant step
+struct SplIrBasicInductionVariable {
+    std::shared_ptr<SplIrOperand> value, init, next;
+    int step = 0;
+    SplIrInstructionList::iterator update;
+};
+
+// induction variable strength reduction on ssa form, an induction variable
+// scaled by a constant gets a phi instruction of its own stepped by an
+// addition in place of the multiplication, then tests of a basic induction
+// variable against a constant are rewritten to test a reduced one (linear
+// function test replacement) if nothing else needs the basic one
+class SplIrStrengthReduction {
+  private:
+    SplIrModule &ir_module;
+    const SplIrDominatorTree &dominator_tree;
+    const SplIrLoop &loop;
+    std::shared_ptr<SplIrBasicBlock> preheader, latch;
+    std::vector<SplIrInstructionList::iterator> instructions;
+    std::unordered_map<SplIrOperand *, SplIrInstructionList::iterator>
+        definitions;
+    std::unordered_map<SplIrOperand *, SplIrBasicInductionVariable> basics;
+    std::unordered_map<SplIrOperand *, SplIrInductionVariable> derived;
+    // the phi instruction and its value on the back edge replacing a derived
+    // induction variable
+    std::unordered_map<SplIrOperand *, std::pair<std::shared_ptr<SplIrOperand>,
+                                                 std::shared_ptr<SplIrOperand>>>
+        reduced;
+
+    bool is_invariant(const std::shared_ptr<SplIrOperand> &op) {
+        return op->type == SplIrOperandType::R_VALUE_CONSTANT ||
+               (is_ssa_value(ir_module, op) &&
+                definitions.count(op.get()) == 0);
+    }
+
+    bool get_induction_variable(const std::shared_ptr<SplIrOperand> &op,
+                                SplIrInductionVariable &iv) {
+        if (basics.count(op.get()) > 0) {
+            iv = SplIrInductionVariable();
+            iv.basic = op;
+            return true;
+        }
+        auto it = derived.find(op.get());
+        if (it == derived.end()) {
+            return false;
+        }
+        iv = it->second;
+        return true;
+    }
+
+    bool derive(const std::shared_ptr<SplIrInstruction> &inst,
+                SplIrInductionVariable &iv) {
+        auto uses = inst->uses();
+        int constant;
+        switch (inst->type) {
+        case SplIrInstructionType::ASSIGN:
+            return get_induction_variable(*uses[0], iv);
+        case SplIrInstructionType::ASSIGN_ADD: {
+            auto lhs = *uses[0], rhs = *uses[1];
+            if (!get_induction_variable(lhs, iv)) {
+                std::swap(lhs, rhs);
+                if (!get_induction_variable(lhs, iv)) {
+                    return false;
+                }
+            }
+            if (spl_ir_get_constant(rhs, constant)) {
+                iv.offset = spl_ir_add(iv.offset, constant);
+                return true;
+            }
+            if (!is_invariant(rhs)) {
+                return false;
+            }
+            iv.base.add_term(rhs, 1);
+            return true;
+        }
+        case SplIrInstructionType::ASSIGN_MINUS:
+            if (!get_induction_variable(*uses[0], iv)) {
+                return false;
+            }
+            if (spl_ir_get_constant(*uses[1], constant)) {
+                iv.offset =
+                    spl_ir_add(iv.offset, spl_ir_multiply(constant, -1));
+                return true;
+            }
+            if (!is_invariant(*uses[1])) {
+                return false;
+            }
+            iv.base.add_term(*uses[1], -1);
+            return true;
+        case SplIrInstructionType::ASSIGN_MUL: {
+            auto lhs = *uses[0], rhs = *uses[1];
+            if (!spl_ir_get_constant(rhs, constant)) {
+                std::swap(lhs, rhs);
+            }
+            if (!spl_ir_get_constant(rhs, constant) ||
+                !get_induction_variable(lhs, iv)) {
+                return false;
+            }
+            iv.scale = spl_ir_multiply(iv.scale, constant);
+            for (auto &term : iv.base.terms) {
+                term.second = spl_ir_multiply(term.second, constant);
+            }
+            iv.offset = spl_ir_multiply(iv.offset, constant);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    void find_basic_induction_variables() {
+        for (auto it = loop.header->head;
+             it != ir_module.ir.end() && (*it)->parent == loop.header; it++) {
+            if ((*it)->type != SplIrInstructionType::PHI) {
+                continue;
+            }
+            auto phi = std::static_pointer_cast<SplIrPhiInstruction>(*it);
+            SplIrBasicInductionVariable basic;
+            basic.value = phi->dst;
+            for (auto &incoming : phi->incomings) {
+                if (incoming.first == preheader) {
+                    basic.init = incoming.second;
+                } else {
+                    basic.next = incoming.second;
+                }
+            }
+            if (basic.init == nullptr || basic.next == nullptr ||
+                definitions.count(basic.next.get()) == 0) {
+                continue;
+            }
+            basic.update = definitions[basic.next.get()];
+            auto update = *basic.update;
+            auto uses = update->uses();
+            int constant;
+            if (update->type == SplIrInstructionType::ASSIGN_ADD &&
+                ((*uses[0] == phi->dst &&
+                  spl_ir_get_constant(*uses[1], constant)) ||
+                 (*uses[1] == phi->dst &&
+                  spl_ir_get_constant(*uses[0], constant)))) {
+                basic.step = constant;
+            } else if (update->type == SplIrInstructionType::ASSIGN_MINUS &&
+                       *uses[0] == phi->dst &&
+                       spl_ir_get_constant(*uses[1], constant)) {
+                basic.step = spl_ir_multiply(constant, -1);
+            } else {
+                continue;
+            }
+            basics[phi->dst.get()] = basic;
+        }
+    }
+
+    void find_derived_induction_variables() {
+        bool found = true;
+        while (found) {
+            found = false;
+            for (auto it : instructions) {
+                auto def = (*it)->def();
+                SplIrInductionVariable iv;
+                if (def == nullptr || !is_ssa_value(ir_module, *def) ||
+                    (*it)->type == SplIrInstructionType::PHI ||
+                    derived.count(def->get()) > 0 || !derive(*it, iv)) {
+                    continue;
+                }
+                derived[def->get()] = iv;
+                found = true;
+            }
+        }
+    }
+
+    // worth a phi instruction of its own if it is scaled and read in the loop
+    // by more than the computation of another induction variable
+    bool is_worth_reducing(const std::shared_ptr<SplIrOperand> &op,
+                           const SplIrInductionVariable &iv) {
+        if (iv.scale == 0 || iv.scale == 1) {
+            return false;
+        }
+        for (auto &inst : ir_module.use_lists[op->repr]) {
+            auto def = inst->def();
+            if (loop.contains(inst->parent) &&
+                (def == nullptr || derived.count(def->get()) == 0)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // value on entry to the loop, computed in the preheader
+    std::shared_ptr<SplIrOperand>
+    get_entry_value(const SplIrBasicInductionVariable &basic,
+                    const SplIrInductionVariable &iv) {
+        SplIrLinearForm form;
+        int init;
+        if (spl_ir_get_constant(basic.init, init)) {
+            form.add_constant(spl_ir_multiply(init, iv.scale));
+        } else {
+            form.add_term(basic.init, iv.scale);
+        }
+        for (auto &term : iv.base.terms) {
+            form.add_term(term.first, term.second);
+        }
+        form.add_constant(iv.offset);
+        if (spl_ir_count_instructions(form) == 0) {
+            return form.terms.empty()
+                       ? spl_ir_make_constant(ir_module, form.constant)
+                       : form.terms.front().first;
+        }
+        auto dst = make_ssa_temporary(ir_module);
+        auto pos = spl_ir_get_preheader_end(ir_module, preheader);
+        for (auto &inst : spl_ir_emit_linear_form(ir_module, form, dst)) {
+            ir_module.insert_instruction(pos, inst, preheader);
+        }
+        return dst;
+    }
+
+    void reduce(const std::shared_ptr<SplIrOperand> &op,
+                const SplIrInductionVariable &iv) {
+        auto &basic = basics[iv.basic.get()];
+        auto entry = get_entry_value(basic, iv);
+        auto value = make_ssa_temporary(ir_module),
+             next = make_ssa_temporary(ir_module);
+        // stepped right after the basic induction variable
+        int step = spl_ir_multiply(basic.step, iv.scale);
+        auto type = SplIrInstructionType::ASSIGN_ADD;
+        if (step < 0 && step != INT32_MIN) {
+            type = SplIrInstructionType::ASSIGN_MINUS;
+            step = -step;
+        }
+        ir_module.insert_instruction(
+            std::next(basic.update),
+            spl_ir_make_arithmetic(type, next, value,
+                                   spl_ir_make_constant(ir_module, step)),
+            (*basic.update)->parent);
+        auto phi = std::make_shared<SplIrPhiInstruction>(value);
+        phi->add_incoming(preheader, entry);
+        phi->add_incoming(latch, next);
+        auto pos = loop.header->head;
+        while (pos != ir_module.ir.end() && (*pos)->parent == loop.header &&
+               ((*pos)->type == SplIrInstructionType::LABEL ||
+                (*pos)->type == SplIrInstructionType::PHI)) {
+            pos++;
+        }
+        ir_module.insert_instruction(pos, phi, loop.header);
+        // the value computed in the loop is still read after it
+        auto users = ir_module.use_lists[op->repr];
+        for (auto &inst : users) {
+            auto def = inst->def();
+            if (loop.contains(inst->parent) && (def == nullptr || *def != op)) {
+                ir_module.replace_usage(inst, op, value);
+            }
+        }
+        reduced[op.get()] = {value, next};
+    }
+
+    // the basic induction variable goes on in steps toward the constant it
+    // is tested against in every iteration, so the values it is tested with
+    // stay within a step past the bound and scaling them does not wrap around
+    bool replace_test(const SplIrBasicInductionVariable &basic,
+                      const std::shared_ptr<SplIrOperand> &reduced_op,
+                      SplIrInstructionList::iterator it) {
+        auto &iv = derived[reduced_op.get()];
+        auto &values = reduced[reduced_op.get()];
+        auto inst_if_goto =
+            std::static_pointer_cast<SplIrIfGotoInstruction>(*it);
+        auto tested = inst_if_goto->lhs, bound = inst_if_goto->rhs;
+        auto relop = inst_if_goto->relop;
+        if (tested != basic.value && tested != basic.next) {
+            std::swap(tested, bound);
+            relop = SplIrIfGotoInstruction::swapped_relop(relop);
+        }
+        int init, limit;
+        if (!spl_ir_get_constant(basic.init, init) ||
+            !spl_ir_get_constant(bound, limit) ||
+            !dominator_tree.dominates(inst_if_goto->parent, latch)) {
+            return false;
+        }
+        auto target = spl_ir_get_jump_target(inst_if_goto->parent,
+                                             inst_if_goto->label.value());
+        auto next = std::next(it);
+        if (target == nullptr || next == ir_module.ir.end() ||
+            loop.contains(target) == loop.contains((*next)->parent)) {
+            return false;
+        }
+        // the relop holding while the loop goes on
+        if (!loop.contains(target)) {
+            relop = SplIrIfGotoInstruction::negated_relop(relop);
+        }
+        bool upward = relop == SplIrIfGotoInstruction::LT ||
+                      relop == SplIrIfGotoInstruction::LE;
+        bool downward = relop == SplIrIfGotoInstruction::GT ||
+                        relop == SplIrIfGotoInstruction::GE;
+        if (!(basic.step > 0 && upward) && !(basic.step < 0 && downward)) {
+            return false;
+        }
+        int64_t range =
+            std::max(std::abs(int64_t(init)), std::abs(int64_t(limit))) +
+            2 * std::abs(int64_t(basic.step));
+        if (range * iv.scale + std::abs(int64_t(iv.offset)) > INT32_MAX) {
+            return false;
+        }
+        ir_module.replace_usage(*it, tested,
+                                tested == basic.value ? values.first
+                                                      : values.second);
+        ir_module.replace_usage(
+            *it, bound,
+            spl_ir_make_constant(ir_module,
+                                 int(int64_t(limit) * iv.scale + iv.offset)));
+        return true;
+    }
+
+    bool is_test(const std::shared_ptr<SplIrInstruction> &inst,
+                 const SplIrBasicInductionVariable &basic) {
+        if (inst->type != SplIrInstructionType::IF_GOTO ||
+            !loop.contains(inst->parent)) {
+            return false;
+        }
+        auto inst_if_goto =
+            std::static_pointer_cast<SplIrIfGotoInstruction>(inst);
+        auto tested = inst_if_goto->lhs, bound = inst_if_goto->rhs;
+        if (tested != basic.value && tested != basic.next) {
+            std::swap(tested, bound);
+        }
+        return (tested == basic.value || tested == basic.next) &&
+               bound->type == SplIrOperandType::R_VALUE_CONSTANT;
+    }
+
+    // the basic induction variable and what is derived from it must be read
+    // by nothing but their own computations and the tests
+    bool replace_tests(const SplIrBasicInductionVariable &basic) {
+        std::unordered_set<SplIrOperand *> family = {basic.value.get(),
+                                                     basic.next.get()};
+        std::shared_ptr<SplIrOperand> reduced_op = nullptr;
+        for (auto &[op, iv] : derived) {
+            if (iv.basic != basic.value) {
+                continue;
+            }
+            family.insert(op);
+            if (reduced.count(op) > 0 && iv.base.terms.empty() &&
+                iv.scale > 0) {
+                reduced_op = *(*definitions[op])->def();
+            }
+        }
+        if (reduced_op == nullptr) {
+            return false;
+        }
+        std::unordered_set<SplIrInstruction *> tests;
+        for (auto member : family) {
+            for (auto &inst : ir_module.use_lists[member->repr]) {
+                auto def = inst->def();
+                if (def != nullptr && family.count(def->get()) > 0) {
+                    continue;
+                }
+                if (!is_test(inst, basic)) {
+                    return false;
+                }
+                tests.insert(inst.get());
+            }
+        }
+        bool changed = false;
+        for (auto it : instructions) {
+            if (tests.count(it->get()) > 0) {
+                changed |= replace_test(basic, reduced_op, it);
+            }
+        }
+        return changed;
+    }
+
+    // use lists may hold instructions no longer reading op
+    bool is_read(const std::shared_ptr<SplIrOperand> &op) {
+        for (auto &inst : ir_module.use_lists[op->repr]) {
+            for (auto use : inst->uses()) {
+                if (*use == op) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // what the reduced induction variables replaced is left unread, which
+    // must not make outer loops reduce what it reads
+    void erase_dead_definitions() {
+        bool erased = true;
+        while (erased) {
+            erased = false;
+            for (auto it = derived.begin(); it != derived.end();) {
+                auto it_def = definitions[it->first];
+                if (!is_read(*(*it_def)->def()) &&
+                    ir_module.erase_instruction_in_place(it_def)) {
+                    definitions.erase(it->first);
+                    it = derived.erase(it);
+                    erased = true;
+                } else {
+                    it++;
+                }
+            }
+        }
+    }
+
+  public:
+    SplIrStrengthReduction(SplIrModule &ir_module,
+                           const SplIrDominatorTree &dominator_tree,
+                           const SplIrLoop &loop)
+        : ir_module(ir_module), dominator_tree(dominator_tree), loop(loop) {}
+
+    bool run() {
+        preheader = spl_ir_get_preheader(loop);
+        if (preheader == nullptr || loop.latches.size() != 1 ||
+            loop.header->predecessors.size() != 2) {
+            return false;
+        }
+        latch = loop.latches.front();
+        for (auto &basic_block : loop.basic_blocks) {
+            for (auto it = basic_block->head;
+                 it != ir_module.ir.end() && (*it)->parent == basic_block;
+                 it++) {
+                instructions.push_back(it);
+                auto def = (*it)->def();
+                if (def != nullptr && is_ssa_value(ir_module, *def)) {
+                    definitions[def->get()] = it;
+                }
+            }
+        }
+        find_basic_induction_variables();
+        find_derived_induction_variables();
+        std::vector<std::pair<std::shared_ptr<SplIrOperand>,
+                              SplIrInductionVariable>>
+            candidates;
+        for (auto &[op, iv] : derived) {
+            auto def = *(*definitions[op])->def();
+            if (is_worth_reducing(def, iv)) {
+                candidates.emplace_back(def, iv);
+            }
+        }
+        for (auto &[op, iv] : candidates) {
+            reduce(op, iv);
+        }
+        for (auto &[op, basic] : basics) {
+            replace_tests(basic);
+        }
+        erase_dead_definitions();
+        return !candidates.empty();
+    }
+};
+
+bool reduce_induction_variables(SplIrModule &ir_module) {
+    bool changed = false;
+    auto &manager = ir_module.analyses();
+    for (auto &function : manager.get_functions()) {
+        auto &dominator_tree = manager.get_dominator_tree(function->name);
+        for (auto &loop : manager.get_natural_loops(function->name).loops) {
+            SplIrStrengthReduction reduction(ir_module, dominator_tree, *loop);
+            changed |= reduction.run();
+        }
+    }
+    if (changed) {
+        ir_module.rebuild_use_lists();
+    }
+    return changed;
+}
+
+bool fold_constant_branches(SplIrModule &ir_module) {
+    bool changed = false;
+    for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+        auto current = it++;
+        if ((*current)->type != SplIrInstructionType::IF_GOTO) {
+            continue;
+        }
+        auto inst_if_goto =
+            std::static_pointer_cast<SplIrIfGotoInstruction>(*current);
+        int lhs, rhs;
+        if (!spl_ir_get_constant(inst_if_goto->lhs, lhs) ||
+            !spl_ir_get_constant(inst_if_goto->rhs, rhs)) {
+            continue;
+        }
+        if (spl_ir_evaluate_relop(inst_if_goto->relop, lhs, rhs)) {
+            ir_module.replace_instruction(
+                current, std::make_shared<SplIrGotoInstruction>(
+                             inst_if_goto->label.value()));
+        } else {
+            ir_module.erase_instruction(current);
+        }
+        changed = true;
+    }
+    if (changed) {
+        ir_module.rebuild_basic_blocks();
+    }
+    return changed;
+}
+
+// jump threading outside ssa form, branches jumping to another branch are
+// retargeted to where that one is bound to go, the code reached only by an
+// unconditional jump is moved to replace the jump, jumps to the next
+// instruction and labels no longer jumped to are dropped
+class SplIrJumpThreading {
+  private:
+    // long chains of jumps are cut short to keep the pass linear
+    static const int max_thread_length = 8;
+
+    SplIrModule &ir_module;
+    std::unordered_map<SplIrOperand *, SplIrInstructionList::iterator>
+        labels;
+
+    // values of lhs the condition holds for, given rhs is a constant
+    static bool get_range(SplIrIfGotoInstruction::Relop relop, int rhs,
+                          int64_t &lo, int64_t &hi) {
+        lo = INT32_MIN;
+        hi = INT32_MAX;
+        switch (relop) {
+        case SplIrIfGotoInstruction::EQ:
+            lo = hi = rhs;
+            return true;
+        case SplIrIfGotoInstruction::NE:
+            return false;
+        case SplIrIfGotoInstruction::LT:
+            hi = int64_t(rhs) - 1;
+            return true;
+        case SplIrIfGotoInstruction::LE:
+            hi = rhs;
+            return true;
+        case SplIrIfGotoInstruction::GT:
+            lo = int64_t(rhs) + 1;
+            return true;
+        case SplIrIfGotoInstruction::GE:
+            lo = rhs;
+            return true;
+        }
+        throw std::runtime_error("Invalid relop");
+    }
+
+    static bool holds_within(SplIrIfGotoInstruction::Relop relop, int rhs,
+                             int64_t lo, int64_t hi) {
+        switch (relop) {
+        case SplIrIfGotoInstruction::EQ:
+            return lo == rhs && hi == rhs;
+        case SplIrIfGotoInstruction::NE:
+            return rhs < lo || rhs > hi;
+        case SplIrIfGotoInstruction::LT:
+            return hi < rhs;
+        case SplIrIfGotoInstruction::LE:
+            return hi <= rhs;
+        case SplIrIfGotoInstruction::GT:
+            return lo > rhs;
+        case SplIrIfGotoInstruction::GE:
+            return lo >= rhs;
+        }
+        throw std::runtime_error("Invalid relop");
+    }
+
+    // orderings of lhs and rhs the relop holds for, less, equal and greater
+    static int get_orderings(SplIrIfGotoInstruction::Relop relop) {
+        switch (relop) {
+        case SplIrIfGotoInstruction::EQ:
+            return 2;
+        case SplIrIfGotoInstruction::NE:
+            return 5;
+        case SplIrIfGotoInstruction::LT:
+            return 1;
+        case SplIrIfGotoInstruction::LE:
+            return 3;
+        case SplIrIfGotoInstruction::GT:
+            return 4;
+        case SplIrIfGotoInstruction::GE:
+            return 6;
+        }
+        throw std::runtime_error("Invalid relop");
+    }
+
+    // whether the condition of next is decided once that of known holds
+    static bool decide(const std::shared_ptr<SplIrIfGotoInstruction> &known,
+                       const std::shared_ptr<SplIrIfGotoInstruction> &next,
+                       bool &outcome) {
+        auto lhs = known->lhs, rhs = known->rhs;
+        auto relop = known->relop;
+        if (lhs->type == SplIrOperandType::R_VALUE_CONSTANT) {
+            std::swap(lhs, rhs);
+            relop = SplIrIfGotoInstruction::swapped_relop(relop);
+        }
+        auto next_lhs = next->lhs, next_rhs = next->rhs;
+        auto next_relop = next->relop;
+        if (next_lhs != lhs) {
+            std::swap(next_lhs, next_rhs);
+            next_relop = SplIrIfGotoInstruction::swapped_relop(next_relop);
+        }
+        if (next_lhs != lhs) {
+            return false;
+        }
+        auto negated_relop =
+            SplIrIfGotoInstruction::negated_relop(next_relop);
+        if (next_rhs == rhs) {
+            int orderings = get_orderings(relop);
+            if ((orderings & ~get_orderings(next_relop)) == 0) {
+                outcome = true;
+                return true;
+            }
+            if ((orderings & ~get_orderings(negated_relop)) == 0) {
+                outcome = false;
+                return true;
+            }
+            return false;
+        }
+        int constant, next_constant;
+        int64_t lo, hi;
+        if (!spl_ir_get_constant(rhs, constant) ||
+            !spl_ir_get_constant(next_rhs, next_constant) ||
+            !get_range(relop, constant, lo, hi)) {
+            return false;
+        }
+        if (holds_within(next_relop, next_constant, lo, hi)) {
+            outcome = true;
+            return true;
+        }
+        if (holds_within(negated_relop, next_constant, lo, hi)) {
+            outcome = false;
+            return true;
+        }
+        return false;
+    }
+
+    // the first instruction other than a label from the position on
+    SplIrInstructionList::iterator
+    skip_labels(SplIrInstructionList::iterator it) {
+        while (it != ir_module.ir.end() &&
+               (*it)->type == SplIrInstructionType::LABEL) {
+            it++;
+        }
+        return it;
+    }
+
+    std::shared_ptr<SplIrOperand>
+    get_label(const std::shared_ptr<SplIrInstruction> &inst) {
+        if (inst->type == SplIrInstructionType::GOTO) {
+            return std::static_pointer_cast<SplIrGotoInstruction>(inst)
+                ->label.value();
+        }
+        return std::static_pointer_cast<SplIrIfGotoInstruction>(inst)
+            ->label.value();
+    }
+
+    // the label in front of the instruction, made if there is none
+    std::shared_ptr<SplIrOperand>
+    get_or_make_label(SplIrInstructionList::iterator it) {
+        if (it != ir_module.ir.begin() &&
+            (*std::prev(it))->type == SplIrInstructionType::LABEL) {
+            return std::static_pointer_cast<SplIrLabelInstruction>(
+                       *std::prev(it))
+                ->label;
+        }
+        auto label = ir_module.label_counter->next();
+        labels[label.get()] = ir_module.insert_instruction(
+            it, std::make_shared<SplIrLabelInstruction>(label),
+            (*it)->parent);
+        return label;
+    }
+
+    // where the branch ends up once it jumps, jumps going around in circles
+    // are left alone
+    std::shared_ptr<SplIrOperand>
+    thread(const std::shared_ptr<SplIrInstruction> &inst) {
+        auto label = get_label(inst);
+        std::unordered_set<SplIrOperand *> visited = {label.get()};
+        for (int i = 0; i < max_thread_length; i++) {
+            auto it = labels.find(label.get());
+            if (it == labels.end()) {
+                break;
+            }
+            auto target = skip_labels(it->second);
+            if (target == ir_module.ir.end() || *target == inst) {
+                break;
+            }
+            if ((*target)->type == SplIrInstructionType::GOTO) {
+                label = get_label(*target);
+                if (!visited.insert(label.get()).second) {
+                    return get_label(inst);
+                }
+                continue;
+            }
+            bool outcome;
+            if (inst->type != SplIrInstructionType::IF_GOTO ||
+                (*target)->type != SplIrInstructionType::IF_GOTO ||
+                !decide(std::static_pointer_cast<SplIrIfGotoInstruction>(inst),
+                        std::static_pointer_cast<SplIrIfGotoInstruction>(
+                            *target),
+                        outcome)) {
+                break;
+            }
+            auto next = std::next(target);
+            if (!outcome && next == ir_module.ir.end()) {
+                break;
+            }
+            label = outcome ? get_label(*target) : get_or_make_label(next);
+            if (!visited.insert(label.get()).second) {
+                return get_label(inst);
+            }
+        }
+        return label;
+    }
+
+    bool thread_branches() {
+        bool changed = false;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+            auto type = (*it)->type;
+            if (type != SplIrInstructionType::GOTO &&
+                type != SplIrInstructionType::IF_GOTO) {
+                continue;
+            }
+            auto label = get_label(*it), new_label = thread(*it);
+            if (new_label != label) {
+                ir_module.replace_usage(*it, label, new_label);
+                changed = true;
+            }
+            // a jump to a return returns right away
+            auto it_label = labels.find(new_label.get());
+            if (type != SplIrInstructionType::GOTO ||
+                it_label == labels.end()) {
+                continue;
+            }
+            auto target = skip_labels(it_label->second);
+            if (target != ir_module.ir.end() &&
+                (*target)->type == SplIrInstructionType::RETURN) {
+                ir_module.replace_instruction(
+                    it, spl_ir_clone_instruction(*target));
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    // branches to the instruction they would fall through to anyway
+    bool remove_redundant_branches() {
+        bool changed = false;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+            auto current = it++;
+            auto type = (*current)->type;
+            if (type != SplIrInstructionType::GOTO &&
+                type != SplIrInstructionType::IF_GOTO) {
+                continue;
+            }
+            auto label = get_label(*current);
+            for (auto next = it; next != ir_module.ir.end() &&
+                                 (*next)->type == SplIrInstructionType::LABEL;
+                 next++) {
+                if (std::static_pointer_cast<SplIrLabelInstruction>(*next)
+                        ->label == label) {
+                    ir_module.erase_instruction(current);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+        return changed;
+    }
+
+    // code reached by nothing but a jump takes its place, if it does not
+    // fall through
+    bool move_jump_targets() {
+        bool changed = false;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+            auto current = it++;
+            if ((*current)->type != SplIrInstructionType::GOTO) {
+                continue;
+            }
+            auto label = get_label(*current);
+            auto it_found = labels.find(label.get());
+            if (it_found == labels.end() ||
+                ir_module.use_lists[label->repr].size() != 2) {
+                continue;
+            }
+            auto it_label = it_found->second;
+            if (it_label == it || it_label == ir_module.ir.begin()) {
+                continue;
+            }
+            auto prev_type = (*std::prev(it_label))->type;
+            if (prev_type != SplIrInstructionType::GOTO &&
+                prev_type != SplIrInstructionType::RETURN) {
+                continue;
+            }
+            auto end = std::next(it_label);
+            bool movable = false;
+            for (; end != ir_module.ir.end() && end != current &&
+                   (*end)->type != SplIrInstructionType::LABEL &&
+                   (*end)->type != SplIrInstructionType::FUNCTION;
+                 end++) {
+                auto type = (*end)->type;
+                if (type == SplIrInstructionType::GOTO ||
+                    type == SplIrInstructionType::RETURN) {
+                    movable = true;
+                    end++;
+                    break;
+                }
+            }
+            if (!movable) {
+                continue;
+            }
+            ir_module.ir.splice(current, ir_module.ir, std::next(it_label),
+                                end);
+            ir_module.erase_instruction(current);
+            ir_module.erase_instruction(it_label);
+            labels.erase(label.get());
+            changed = true;
+        }
+        return changed;
+    }
+
+    bool remove_unused_labels() {
+        bool changed = false;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+            auto current = it++;
+            if ((*current)->type != SplIrInstructionType::LABEL) {
+                continue;
+            }
+            auto label =
+                std::static_pointer_cast<SplIrLabelInstruction>(*current)
+                    ->label;
+            if (ir_module.use_lists[label->repr].size() == 1) {
+                labels.erase(label.get());
+                ir_module.erase_instruction(current);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+  public:
+    explicit SplIrJumpThreading(SplIrModule &ir_module)
+        : ir_module(ir_module) {}
+
+    bool run() {
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+            if ((*it)->type == SplIrInstructionType::LABEL) {
+                labels[std::static_pointer_cast<SplIrLabelInstruction>(*it)
+                           ->label.get()] = it;
+            }
+        }
+        bool changed = false, round_changed = true;
+        while (round_changed) {
+            round_changed = thread_branches();
+            round_changed |= remove_redundant_branches();
+            round_changed |= move_jump_targets();
+            round_changed |= remove_unused_labels();
+            changed |= round_changed;
+        }
+        return changed;
+    }
+};
+
+bool thread_jumps(SplIrModule &ir_module) {
+    SplIrJumpThreading threading(ir_module);
+    if (!threading.run()) {
+        return false;
+    }
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+class SplIrInliner {
+  private:
+    SplIrModule &ir_module;
+    SplIrCallGraph call_graph;
+    // the FUNCTION instruction of each function
+    std::unordered_map<std::string, SplIrInstructionList::iterator> entries;
+
+    // labels, parameters and declarations cost nothing at run time
+    int get_size(const std::string &func_name) {
+        auto entry = entries.at(func_name);
+        auto end = spl_ir_get_function_end(ir_module, entry);
+        int size = 0;
+        for (auto it = std::next(entry); it != end; it++) {
+            size += (*it)->type != SplIrInstructionType::LABEL &&
+                    (*it)->type != SplIrInstructionType::PARAM &&
+                    (*it)->type != SplIrInstructionType::DEC;
+        }
+        return size;
+    }
+
+    bool should_inline(const std::string &caller, const std::string &callee) {
+        return callee != caller && entries.count(callee) > 0 &&
+               !call_graph.is_recursive(callee) &&
+               (call_graph.get_call_count(callee) == 1 ||
+                get_size(callee) <= SPL_IR_INLINE_THRESHOLD);
+    }
+
+    // the arguments become copies to the parameters, the call becomes the
+    // callee body and each return a copy to the result and a jump past the
+    // body; returns the instruction after the inlined body, or the call
+    // itself if its arguments are not found
+    SplIrInstructionList::iterator
+    inline_call(SplIrInstructionList::iterator caller_entry,
+                SplIrInstructionList::iterator call) {
+        auto inst_call =
+            std::static_pointer_cast<SplIrAssignCallInstruction>(*call);
+        auto callee_entry = entries.at(inst_call->func->repr);
+        auto callee_end = spl_ir_get_function_end(ir_module, callee_entry);
+        std::vector<std::shared_ptr<SplIrOperand>> params;
+        for (auto it = std::next(callee_entry);
+             it != callee_end && (*it)->type == SplIrInstructionType::PARAM;
+             it++) {
+            params.push_back(
+                std::static_pointer_cast<SplIrParamInstruction>(*it)->param);
+        }
+        auto args = spl_ir_get_call_args(ir_module, call);
+        if (args.size() < params.size()) {
+            return call;
+        }
+        SplIrOperandRenaming renamed;
+        auto rename = [&](const std::shared_ptr<SplIrOperand> &op) {
+            return spl_ir_rename_operand(ir_module, renamed, op);
+        };
+        for (size_t i = 0; i < params.size(); i++) {
+            auto arg = std::static_pointer_cast<SplIrArgInstruction>(*args[i]);
+            *args[i] = std::make_shared<SplIrAssignInstruction>(
+                rename(params[i]), arg->arg);
+        }
+        // declarations go to the entry of the caller
+        auto decl_pos = std::next(caller_entry);
+        while ((*decl_pos)->type == SplIrInstructionType::PARAM) {
+            decl_pos++;
+        }
+        auto cont = ir_module.label_counter->next();
+        for (auto it = std::next(callee_entry, params.size() + 1);
+             it != callee_end; it++) {
+            if ((*it)->type == SplIrInstructionType::RETURN) {
+                auto src =
+                    std::static_pointer_cast<SplIrReturnInstruction>(*it)->src;
+                ir_module.ir.insert(call,
+                                    std::make_shared<SplIrAssignInstruction>(
+                                        inst_call->dst, rename(src)));
+                ir_module.ir.insert(
+                    call, std::make_shared<SplIrGotoInstruction>(cont));
+                continue;
+            }
+            auto inst = spl_ir_clone_instruction(*it);
+            for (auto &operand : inst->operands) {
+                operand.get() = rename(operand.get());
+            }
+            ir_module.ir.insert(
+                inst->type == SplIrInstructionType::DEC ? decl_pos : call,
+                inst);
+        }
+        // the body usually ends in a return, its jump falls through anyway
+        auto last = std::prev(call);
+        if ((*last)->type == SplIrInstructionType::GOTO &&
+            std::static_pointer_cast<SplIrGotoInstruction>(*last)
+                    ->label.value() == cont) {
+            ir_module.ir.erase(last);
+        }
+        *call = std::make_shared<SplIrLabelInstruction>(cont);
+        return std::next(call);
+    }
+
+  public:
+    explicit SplIrInliner(SplIrModule &ir_module)
+        : ir_module(ir_module),
+          call_graph(ir_module.analyses().get_call_graph()) {
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+            if ((*it)->type == SplIrInstructionType::FUNCTION) {
+                entries[std::static_pointer_cast<SplIrFunctionInstruction>(*it)
+                            ->func->repr] = it;
+            }
+        }
+    }
+
+    bool run() {
+        bool changed = false;
+        // callees come before their callers, so that a copied body has its
+        // own calls inlined already
+        for (auto &component : call_graph.components) {
+            for (auto &func_name : component) {
+                auto entry = entries.at(func_name);
+                auto end = spl_ir_get_function_end(ir_module, entry);
+                for (auto it = std::next(entry); it != end;) {
+                    if ((*it)->type != SplIrInstructionType::ASSIGN_CALL ||
+                        !should_inline(
+                            func_name,
+                            std::static_pointer_cast<
+                                SplIrAssignCallInstruction>(*it)
+                                ->func->repr)) {
+                        it++;
+                        continue;
+                    }
+                    auto next = inline_call(entry, it);
+                    changed |= next != it;
+                    it = next == it ? std::next(it) : next;
+                }
+            }
+        }
+        return changed;
+    }
+};
+
+bool inline_functions(SplIrModule &ir_module) {
+    if (!SplIrInliner(ir_module).run()) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+bool eliminate_dead_functions(SplIrModule &ir_module) {
+    auto &call_graph = ir_module.analyses().get_call_graph();
+    // a module without main is a library, every function is kept
+    if (!call_graph.is_defined("main")) {
+        return false;
+    }
+    auto live = call_graph.get_reachable("main");
+    bool changed = false, dead = false;
+    for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+        if ((*it)->type == SplIrInstructionType::FUNCTION) {
+            dead = live.count(
+                       std::static_pointer_cast<SplIrFunctionInstruction>(*it)
+                           ->func->repr) == 0;
+        }
+        if (dead) {
+            it = ir_module.ir.erase(it);
+            changed = true;
+        } else {
+            it++;
+        }
+    }
+    if (!changed) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+class SplIrTailRecursionElimination {
+  private:
+    struct SplIrTailCall {
+        SplIrInstructionList::iterator call;
+        // the addition or multiplication combining the result with another
+        // value, if any
+        std::shared_ptr<SplIrInstruction> combine;
+        std::shared_ptr<SplIrOperand> other;
+    };
+
+    SplIrModule &ir_module;
+
+    bool is_single_use(const std::shared_ptr<SplIrOperand> &op) {
+        // the definition is in the use list as well
+        return op->type == SplIrOperandType::L_VALUE_TEMPORARY &&
+               ir_module.use_lists[op->repr].size() == 2;
+    }
+
+    bool is_returned(SplIrInstructionList::iterator it,
+                     const std::shared_ptr<SplIrOperand> &op) {
+        return it != ir_module.ir.end() &&
+               (*it)->type == SplIrInstructionType::RETURN &&
+               std::static_pointer_cast<SplIrReturnInstruction>(*it)->src ==
+                   op;
+    }
+
+    bool find_tail_call(SplIrInstructionList::iterator call,
+                        SplIrTailCall &tail_call) {
+        auto result =
+            std::static_pointer_cast<SplIrAssignCallInstruction>(*call)->dst;
+        auto next = std::next(call);
+        tail_call = {call, nullptr, nullptr};
+        if (is_returned(next, result)) {
+            return true;
+        }
+        if (next == ir_module.ir.end() ||
+            ((*next)->type != SplIrInstructionType::ASSIGN_ADD &&
+             (*next)->type != SplIrInstructionType::ASSIGN_MUL) ||
+            !is_single_use(result) || !is_single_use(*(*next)->def()) ||
+            !is_returned(std::next(next), *(*next)->def())) {
+            return false;
+        }
+        auto uses = (*next)->uses();
+        if (*uses[0] == result && *uses[1] != result) {
+            tail_call.other = *uses[1];
+        } else if (*uses[1] == result && *uses[0] != result) {
+            tail_call.other = *uses[0];
+        } else {
+            return false;
+        }
+        tail_call.combine = *next;
+        return true;
+    }
+
+    bool run_on_function(SplIrInstructionList::iterator entry,
+                         SplIrInstructionList::iterator end) {
+        auto func = std::static_pointer_cast<SplIrFunctionInstruction>(*entry)
+                        ->func;
+        std::vector<std::shared_ptr<SplIrOperand>> params;
+        auto body = std::next(entry);
+        for (; body != end && (*body)->type == SplIrInstructionType::PARAM;
+             body++) {
+            params.push_back(
+                std::static_pointer_cast<SplIrParamInstruction>(*body)->param);
+        }
+        std::vector<SplIrTailCall> tail_calls;
+        // the operation of the accumulator, taken from the first tail call
+        // needing one
+        auto acc_type = SplIrInstructionType::ASSIGN;
+        for (auto it = body; it != end; it++) {
+            // memory declared by one activation may be reachable from the
+            // next one through its arguments
+            if ((*it)->type == SplIrInstructionType::DEC) {
+                return false;
+            }
+            SplIrTailCall tail_call;
+            if ((*it)->type != SplIrInstructionType::ASSIGN_CALL ||
+                std::static_pointer_cast<SplIrAssignCallInstruction>(*it)
+                        ->func != func ||
+                !find_tail_call(it, tail_call)) {
+                continue;
+            }
+            if (tail_call.combine != nullptr) {
+                if (acc_type == SplIrInstructionType::ASSIGN) {
+                    acc_type = tail_call.combine->type;
+                } else if (acc_type != tail_call.combine->type) {
+                    continue;
+                }
+            }
+            if (spl_ir_get_call_args(ir_module, it).size() >= params.size()) {
+                tail_calls.push_back(tail_call);
+            }
+        }
+        if (tail_calls.empty()) {
+            return false;
+        }
+        auto start = ir_module.label_counter->next();
+        std::shared_ptr<SplIrOperand> acc = nullptr;
+        if (acc_type != SplIrInstructionType::ASSIGN) {
+            acc = ir_module.var_counter->next();
+            int identity = acc_type == SplIrInstructionType::ASSIGN_ADD ? 0 : 1;
+            ir_module.ir.insert(body, std::make_shared<SplIrAssignInstruction>(
+                                          acc, spl_ir_make_constant(
+                                                   ir_module, identity)));
+        }
+        ir_module.ir.insert(body,
+                            std::make_shared<SplIrLabelInstruction>(start));
+        for (auto &tail_call : tail_calls) {
+            auto call = tail_call.call;
+            // arguments are evaluated before any parameter is reassigned
+            auto args = spl_ir_get_call_args(ir_module, call);
+            std::vector<std::shared_ptr<SplIrOperand>> values;
+            for (size_t i = 0; i < params.size(); i++) {
+                auto value = ir_module.tmp_counter->next();
+                *args[i] = std::make_shared<SplIrAssignInstruction>(
+                    value,
+                    std::static_pointer_cast<SplIrArgInstruction>(*args[i])
+                        ->arg);
+                values.push_back(value);
+            }
+            if (tail_call.combine != nullptr) {
+                ir_module.ir.insert(call, spl_ir_make_arithmetic(
+                                              acc_type, acc, acc,
+                                              tail_call.other));
+            }
+            for (size_t i = 0; i < params.size(); i++) {
+                ir_module.ir.insert(call,
+                                    std::make_shared<SplIrAssignInstruction>(
+                                        params[i], values[i]));
+            }
+            ir_module.ir.insert(call,
+                                std::make_shared<SplIrGotoInstruction>(start));
+            // the call, the combination and the return
+            auto last = std::next(call, tail_call.combine != nullptr ? 3 : 2);
+            ir_module.ir.erase(call, last);
+        }
+        if (acc == nullptr) {
+            return true;
+        }
+        // other returns give back their value combined with the accumulator
+        for (auto it = body; it != end; it++) {
+            if ((*it)->type != SplIrInstructionType::RETURN) {
+                continue;
+            }
+            auto inst_return =
+                std::static_pointer_cast<SplIrReturnInstruction>(*it);
+            auto value = ir_module.tmp_counter->next();
+            ir_module.ir.insert(it,
+                                spl_ir_make_arithmetic(acc_type, value, acc,
+                                                       inst_return->src));
+            inst_return->src = value;
+        }
+        return true;
+    }
+
+  public:
+    explicit SplIrTailRecursionElimination(SplIrModule &ir_module)
+        : ir_module(ir_module) {}
+
+    bool run() {
+        bool changed = false;
+        auto entry = ir_module.ir.begin();
+        while (entry != ir_module.ir.end() &&
+               (*entry)->type != SplIrInstructionType::FUNCTION) {
+            entry++;
+        }
+        while (entry != ir_module.ir.end()) {
+            auto end = std::next(entry);
+            while (end != ir_module.ir.end() &&
+                   (*end)->type != SplIrInstructionType::FUNCTION) {
+                end++;
+            }
+            changed |= run_on_function(entry, end);
+            entry = end;
+        }
+        return changed;
+    }
+};
+
+bool eliminate_tail_recursion(SplIrModule &ir_module) {
+    if (!SplIrTailRecursionElimination(ir_module).run()) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+class SplIrFunctionSpecialization {
+  private:
+    // clones made of one function at most
+    static constexpr size_t max_specializations = 4;
+    // a combination of constants is hot enough for a clone once it is passed
+    // by two calls, or by one in a loop
+    static constexpr int min_heat = 2;
+
+    struct SplIrCallSite {
+        std::string caller;
+        SplIrInstructionList::iterator call;
+        // the ARG instruction of each parameter
+        std::vector<SplIrInstructionList::iterator> args;
+        int heat = 1;
+    };
+    // constant arguments by parameter index
+    using SplIrConstantArguments = std::map<size_t, std::string>;
+
+    SplIrModule &ir_module;
+    SplIrCallGraph call_graph;
+    std::unordered_map<std::string, SplIrInstructionList::iterator> entries;
+    std::unordered_map<std::string, std::vector<SplIrCallSite>> call_sites;
+    // functions some call of which passes more or fewer arguments than
+    // there are parameters
+    std::unordered_set<std::string> irregular;
+
+    std::vector<std::shared_ptr<SplIrOperand>>
+    get_params(SplIrInstructionList::iterator entry) {
+        std::vector<std::shared_ptr<SplIrOperand>> params;
+        for (auto it = std::next(entry);
+             it != ir_module.ir.end() &&
+             (*it)->type == SplIrInstructionType::PARAM;
+             it++) {
+            params.push_back(
+                std::static_pointer_cast<SplIrParamInstruction>(*it)->param);
+        }
+        return params;
+    }
+
+    // whether each parameter keeps its value throughout the function
+    std::vector<bool>
+    get_unchanged(SplIrInstructionList::iterator entry,
+                  const std::vector<std::shared_ptr<SplIrOperand>> &params) {
+        std::vector<bool> unchanged(params.size(), true);
+        auto end = spl_ir_get_function_end(ir_module, entry);
+        for (auto it = std::next(entry, params.size() + 1); it != end; it++) {
+            auto def = (*it)->def();
+            for (size_t i = 0; def != nullptr && i < params.size(); i++) {
+                unchanged[i] = unchanged[i] && *def != params[i];
+            }
+        }
+        return unchanged;
+    }
+
+    int get_size(SplIrInstructionList::iterator entry) {
+        auto end = spl_ir_get_function_end(ir_module, entry);
+        int size = 0;
+        for (auto it = std::next(entry); it != end; it++) {
+            size += (*it)->type != SplIrInstructionType::LABEL;
+        }
+        return size;
+    }
+
+    static std::shared_ptr<SplIrOperand>
+    get_arg(const SplIrCallSite &site, size_t i) {
+        return std::static_pointer_cast<SplIrArgInstruction>(*site.args[i])
+            ->arg;
+    }
+
+    // make the call call func instead, with the constant arguments dropped
+    void retarget(SplIrCallSite &site,
+                  const std::shared_ptr<SplIrOperand> &func,
+                  const SplIrConstantArguments &constants) {
+        std::vector<SplIrInstructionList::iterator> args;
+        for (size_t i = 0; i < site.args.size(); i++) {
+            if (constants.count(i) > 0) {
+                ir_module.ir.erase(site.args[i]);
+            } else {
+                args.push_back(site.args[i]);
+            }
+        }
+        site.args = args;
+        *site.call = std::make_shared<SplIrAssignCallInstruction>(
+            *(*site.call)->def(), func);
+    }
+
+    // the parameters with constants are dropped, they are assigned the
+    // constants at the entry instead
+    void replace_params(SplIrInstructionList::iterator entry,
+                        const SplIrConstantArguments &constants) {
+        auto params = get_params(entry);
+        auto body = std::next(entry, params.size() + 1);
+        for (auto &[i, value] : constants) {
+            auto constant =
+                ir_module.get_or_make_constant_operand_by_name(value);
+            ir_module.ir.insert(body, std::make_shared<SplIrAssignInstruction>(
+                                          params[i], constant));
+        }
+        auto it = std::next(entry);
+        for (size_t i = 0; i < params.size(); i++) {
+            it = constants.count(i) > 0 ? ir_module.ir.erase(it)
+                                        : std::next(it);
+        }
+    }
+
+    bool propagate(const std::string &func_name) {
+        auto entry = entries.at(func_name);
+        auto params = get_params(entry);
+        auto unchanged = get_unchanged(entry, params);
+        auto &sites = call_sites[func_name];
+        SplIrConstantArguments constants;
+        for (size_t i = 0; i < params.size(); i++) {
+            std::string value;
+            bool agreed = true;
+            for (auto &site : sites) {
+                auto arg = get_arg(site, i);
+                // passing the parameter on to itself agrees with anything
+                if (site.caller == func_name && arg == params[i] &&
+                    unchanged[i]) {
+                    continue;
+                }
+                agreed &= arg->type == SplIrOperandType::R_VALUE_CONSTANT &&
+                          (value.empty() || value == arg->repr);
+                value = arg->repr;
+            }
+            if (agreed && !value.empty()) {
+                constants[i] = value;
+            }
+        }
+        if (constants.empty()) {
+            return false;
+        }
+        auto func = std::static_pointer_cast<SplIrFunctionInstruction>(*entry)
+                        ->func;
+        for (auto &site : sites) {
+            retarget(site, func, constants);
+        }
+        replace_params(entry, constants);
+        return true;
+    }
+
+    // a copy of the function with the constant parameters replaced, right
+    // after the function; calls of the copy to the original one passing the
+    // same constants, or the parameters themselves, call the copy as well
+    void specialize(const std::string &func_name,
+                    const SplIrConstantArguments &constants,
+                    std::vector<SplIrCallSite *> &sites) {
+        auto entry = entries.at(func_name);
+        auto end = spl_ir_get_function_end(ir_module, entry);
+        auto params = get_params(entry);
+        auto unchanged = get_unchanged(entry, params);
+        std::string name;
+        for (int k = 1; name.empty() || call_graph.is_defined(name) ||
+                        entries.count(name) > 0;
+             k++) {
+            name = func_name + "_" + std::to_string(k);
+        }
+        auto func = ir_module.get_or_make_function_operand_by_name(name);
+        SplIrOperandRenaming renamed;
+        SplIrInstructionList body(std::next(entry), end);
+        auto clone_entry = ir_module.ir.insert(
+            end, std::make_shared<SplIrFunctionInstruction>(func));
+        entries[name] = clone_entry;
+        std::vector<SplIrCallSite> self_sites;
+        for (auto &original : body) {
+            auto inst = spl_ir_clone_instruction(original);
+            for (auto &operand : inst->operands) {
+                operand.get() =
+                    spl_ir_rename_operand(ir_module, renamed, operand.get());
+            }
+            auto inst_it = ir_module.ir.insert(end, inst);
+            if (inst->type == SplIrInstructionType::ASSIGN_CALL &&
+                std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                        ->func->repr == func_name) {
+                self_sites.push_back(
+                    {name, inst_it, spl_ir_get_call_args(ir_module, inst_it)});
+            }
+        }
+        for (auto &site : self_sites) {
+            bool same = site.args.size() == params.size();
+            for (auto &[i, value] : constants) {
+                if (!same) {
+                    break;
+                }
+                auto arg = get_arg(site, i);
+                same = arg->repr == value ||
+                       (arg == renamed[params[i].get()] && unchanged[i]);
+            }
+            if (same) {
+                retarget(site, func, constants);
+            }
+        }
+        for (auto site : sites) {
+            retarget(*site, func, constants);
+        }
+        replace_params(clone_entry, constants);
+    }
+
+    bool specialize(const std::string &func_name) {
+        auto entry = entries.at(func_name);
+        bool recursive = call_graph.is_recursive(func_name);
+        // the inliner copies small functions and those called once anyway
+        if (func_name == "main" || irregular.count(func_name) > 0 ||
+            get_size(entry) > SPL_IR_SPECIALIZE_THRESHOLD ||
+            (!recursive && (get_size(entry) <= SPL_IR_INLINE_THRESHOLD ||
+                            call_graph.get_call_count(func_name) == 1))) {
+            return false;
+        }
+        auto params = get_params(entry);
+        auto unchanged = get_unchanged(entry, params);
+        // a recursive function is only worth a clone for parameters passed
+        // on to itself as they are, otherwise only the outermost call would
+        // see the constants
+        auto &sites = call_sites[func_name];
+        for (auto &site : sites) {
+            for (size_t i = 0; i < params.size(); i++) {
+                unchanged[i] = unchanged[i] && (site.caller != func_name ||
+                                                get_arg(site, i) == params[i]);
+            }
+        }
+        std::map<SplIrConstantArguments, std::vector<SplIrCallSite *>> groups;
+        for (auto &site : sites) {
+            if (site.caller == func_name) {
+                continue;
+            }
+            SplIrConstantArguments constants;
+            for (size_t i = 0; i < params.size(); i++) {
+                auto arg = get_arg(site, i);
+                if (arg->type == SplIrOperandType::R_VALUE_CONSTANT &&
+                    (!recursive || unchanged[i])) {
+                    constants[i] = arg->repr;
+                }
+            }
+            if (!constants.empty()) {
+                groups[constants].push_back(&site);
+            }
+        }
+        std::vector<std::tuple<int, SplIrConstantArguments,
+                               std::vector<SplIrCallSite *>>>
+            order;
+        for (auto &[constants, group] : groups) {
+            int heat = 0;
+            for (auto site : group) {
+                heat += site->heat;
+            }
+            if (heat >= min_heat) {
+                order.emplace_back(heat, constants, group);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [](const auto &lhs, const auto &rhs) {
+                             return std::get<0>(lhs) > std::get<0>(rhs);
+                         });
+        if (order.size() > max_specializations) {
+            order.resize(max_specializations);
+        }
+        for (auto &[heat, constants, group] : order) {
+            specialize(func_name, constants, group);
+        }
+        return !order.empty();
+    }
+
+  public:
+    explicit SplIrFunctionSpecialization(SplIrModule &ir_module)
+        : ir_module(ir_module),
+          call_graph(ir_module.analyses().get_call_graph()) {
+        auto &manager = ir_module.analyses();
+        std::string current;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+            if ((*it)->type == SplIrInstructionType::FUNCTION) {
+                current =
+                    std::static_pointer_cast<SplIrFunctionInstruction>(*it)
+                        ->func->repr;
+                entries[current] = it;
+            } else if ((*it)->type == SplIrInstructionType::ASSIGN_CALL) {
+                SplIrCallSite site{current, it,
+                                   spl_ir_get_call_args(ir_module, it)};
+                if (manager.get_natural_loops(current).get_loop(
+                        (*it)->parent) != nullptr) {
+                    site.heat = min_heat;
+                }
+                call_sites[std::static_pointer_cast<SplIrAssignCallInstruction>(
+                               *it)
+                               ->func->repr]
+                    .push_back(site);
+            }
+        }
+        for (auto &[func_name, sites] : call_sites) {
+            auto it = entries.find(func_name);
+            if (it == entries.end()) {
+                irregular.insert(func_name);
+                continue;
+            }
+            auto count = get_params(it->second).size();
+            for (auto &site : sites) {
+                if (site.args.size() != count) {
+                    irregular.insert(func_name);
+                }
+            }
+        }
+    }
+
+    bool run() {
+        bool changed = false;
+        // clones copy calls unknown to the call sites collected, so no
+        // parameter is dropped once a clone exists
+        for (auto &func_name : call_graph.functions) {
+            if (irregular.count(func_name) == 0 &&
+                call_sites.count(func_name) > 0) {
+                changed |= propagate(func_name);
+            }
+        }
+        for (auto &func_name : call_graph.functions) {
+            changed |= specialize(func_name);
+        }
+        return changed;
+    }
+};
+
+bool specialize_functions(SplIrModule &ir_module) {
+    if (!SplIrFunctionSpecialization(ir_module).run()) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+// runs the ir of a module the way it would run on the target, except that
+// anything whose outcome is unknown at compile time, reading an undefined
+// variable or memory not declared included, makes it fail rather than guess
+class SplIrEvaluator {
+  private:
+    struct SplIrFrame {
+        SplIrInstructionList::iterator pc;
+        // the basic block being run and the one it is entered from, for phi
+        // instructions
+        SplIrBasicBlock *basic_block = nullptr, *predecessor = nullptr;
+        std::unordered_map<std::string, int> values;
+        // the address of each declared variable
+        std::unordered_map<std::string, int> addresses;
+        // arguments left for the parameters, the first one last
+        std::vector<int> params;
+        // arguments passed so far to the call coming next
+        std::vector<int> args;
+    };
+
+    // memory starts at a nonzero address so null pointers stay invalid
+    static constexpr int memory_base = 4;
+
+    SplIrModule &ir_module;
+    long fuel;
+    std::unordered_map<std::string, SplIrInstructionList::iterator> entries,
+        labels;
+    std::vector<SplIrFrame> frames;
+    std::vector<int> memory;
+    std::vector<bool> initialized;
+
+    bool get_value(const SplIrFrame &frame,
+                   const std::shared_ptr<SplIrOperand> &op, int &value) {
+        if (spl_ir_get_constant(op, value)) {
+            return true;
+        }
+        auto it = frame.values.find(op->repr);
+        if (it == frame.values.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    bool get_word(int address, size_t &word) {
+        int64_t offset = int64_t(address) - memory_base;
+        if (offset < 0 || offset % 4 != 0 ||
+            offset / 4 >= int64_t(memory.size())) {
+            return false;
+        }
+        word = offset / 4;
+        return true;
+    }
+
+    // a basic block jumping to itself is entered anew
+    void jump(SplIrFrame &frame, const std::shared_ptr<SplIrOperand> &label) {
+        frame.pc = labels.at(label->repr);
+        frame.predecessor = frame.basic_block;
+        frame.basic_block = (*frame.pc)->parent.get();
+    }
+
+    // phi instructions at the head of a basic block read their incoming
+    // values all at once
+    bool run_phis(SplIrFrame &frame) {
+        std::vector<std::pair<std::string, int>> values;
+        for (; frame.pc != ir_module.ir.end() &&
+               (*frame.pc)->type == SplIrInstructionType::PHI;
+             frame.pc++) {
+            auto inst_phi = std::static_pointer_cast<SplIrPhiInstruction>(
+                *frame.pc);
+            auto incoming = std::find_if(
+                inst_phi->incomings.begin(), inst_phi->incomings.end(),
+                [&](const auto &incoming) {
+                    return incoming.first.get() == frame.predecessor;
+                });
+            int value;
+            if (incoming == inst_phi->incomings.end() ||
+                !get_value(frame, incoming->second, value) || --fuel < 0) {
+                return false;
+            }
+            values.emplace_back(inst_phi->dst->repr, value);
+        }
+        for (auto &[repr, value] : values) {
+            frame.values[repr] = value;
+        }
+        return true;
+    }
+
+    bool enter(const std::string &func_name, std::vector<int> params) {
+        auto entry = entries.find(func_name);
+        if (entry == entries.end()) {
+            return false;
+        }
+        frames.emplace_back();
+        frames.back().pc = std::next(entry->second);
+        frames.back().params = std::move(params);
+        return true;
+    }
+
+    // run a single instruction, the return value of the outermost function
+    // ends up in result once no frame is left
+    bool step(int &result) {
+        auto &frame = frames.back();
+        if (frame.pc == ir_module.ir.end() || --fuel < 0) {
+            return false;
+        }
+        auto inst = *frame.pc;
+        if (inst->parent.get() != frame.basic_block) {
+            frame.predecessor = frame.basic_block;
+            frame.basic_block = inst->parent.get();
+        }
+        frame.pc++;
+        switch (inst->type) {
+        case SplIrInstructionType::LABEL:
+            return true;
+        case SplIrInstructionType::ASSIGN: {
+            auto inst_assign =
+                std::static_pointer_cast<SplIrAssignInstruction>(inst);
+            int value;
+            if (!get_value(frame, inst_assign->src, value)) {
+                return false;
+            }
+            frame.values[inst_assign->dst->repr] = value;
+            return true;
+        }
+        case SplIrInstructionType::ASSIGN_ADD:
+        case SplIrInstructionType::ASSIGN_MINUS:
+        case SplIrInstructionType::ASSIGN_MUL:
+        case SplIrInstructionType::ASSIGN_DIV: {
+            auto uses = inst->uses();
+            int lhs, rhs, value;
+            if (!get_value(frame, *uses[0], lhs) ||
+                !get_value(frame, *uses[1], rhs) ||
+                !spl_ir_fold_arithmetic(inst->type, lhs, rhs, value)) {
+                return false;
+            }
+            frame.values[(*inst->def())->repr] = value;
+            return true;
+        }
+        case SplIrInstructionType::ASSIGN_ADDRESS: {
+            auto inst_address =
+                std::static_pointer_cast<SplIrAssignAddressInstruction>(inst);
+            auto it = frame.addresses.find(inst_address->src->repr);
+            if (it == frame.addresses.end()) {
+                return false;
+            }
+            frame.values[inst_address->dst->repr] = it->second;
+            return true;
+        }
+        case SplIrInstructionType::ASSIGN_DEREF_SRC: {
+            auto inst_deref =
+                std::static_pointer_cast<SplIrAssignDerefSrcInstruction>(inst);
+            int address;
+            size_t word;
+            if (!get_value(frame, inst_deref->src, address) ||
+                !get_word(address, word) || !initialized[word]) {
+                return false;
+            }
+            frame.values[inst_deref->dst->repr] = memory[word];
+            return true;
+        }
+        case SplIrInstructionType::ASSIGN_DEREF_DST: {
+            auto inst_deref =
+                std::static_pointer_cast<SplIrAssignDerefDstInstruction>(inst);
+            int address, value;
+            size_t word;
+            if (!get_value(frame, inst_deref->dst, address) ||
+                !get_word(address, word) ||
+                !get_value(frame, inst_deref->src, value)) {
+                return false;
+            }
+            memory[word] = value;
+            initialized[word] = true;
+            return true;
+        }
+        case SplIrInstructionType::GOTO:
+            jump(frame,
+                 std::static_pointer_cast<SplIrGotoInstruction>(inst)
+                     ->label.value());
+            return true;
+        case SplIrInstructionType::IF_GOTO: {
+            auto inst_if_goto =
+                std::static_pointer_cast<SplIrIfGotoInstruction>(inst);
+            int lhs, rhs;
+            if (!get_value(frame, inst_if_goto->lhs, lhs) ||
+                !get_value(frame, inst_if_goto->rhs, rhs)) {
+                return false;
+            }
+            if (spl_ir_evaluate_relop(inst_if_goto->relop, lhs, rhs)) {
+                jump(frame, inst_if_goto->label.value());
+            }
+            return true;
+        }
+        case SplIrInstructionType::RETURN: {
+            int value;
+            if (!get_value(frame,
+                           std::static_pointer_cast<SplIrReturnInstruction>(
+                               inst)
+                               ->src,
+                           value)) {
+                return false;
+            }
+            frames.pop_back();
+            if (frames.empty()) {
+                result = value;
+            } else {
+                auto &caller = frames.back();
+                caller.values[(*(*caller.pc)->def())->repr] = value;
+                caller.pc++;
+            }
+            return true;
+        }
+        case SplIrInstructionType::DEC: {
+            auto inst_dec = std::static_pointer_cast<SplIrDecInstruction>(inst);
+            // declaring memory costs as much as filling it
+            fuel -= inst_dec->size / 4;
+            if (fuel < 0) {
+                return false;
+            }
+            frame.addresses[inst_dec->variable->repr] =
+                memory_base + memory.size() * 4;
+            memory.resize(memory.size() + inst_dec->size / 4);
+            initialized.resize(memory.size(), false);
+            return true;
+        }
+        case SplIrInstructionType::ARG: {
+            int value;
+            if (!get_value(
+                    frame,
+                    std::static_pointer_cast<SplIrArgInstruction>(inst)->arg,
+                    value)) {
+                return false;
+            }
+            frame.args.push_back(value);
+            return true;
+        }
+        case SplIrInstructionType::ASSIGN_CALL: {
+            // the caller resumes at the call once the callee returns
+            frame.pc--;
+            auto args = std::move(frame.args);
+            frame.args.clear();
+            return enter(
+                std::static_pointer_cast<SplIrAssignCallInstruction>(inst)
+                    ->func->repr,
+                std::move(args));
+        }
+        case SplIrInstructionType::PARAM:
+            if (frame.params.empty()) {
+                return false;
+            }
+            frame.values[std::static_pointer_cast<SplIrParamInstruction>(inst)
+                             ->param->repr] = frame.params.back();
+            frame.params.pop_back();
+            return true;
+        case SplIrInstructionType::WRITE: {
+            int value;
+            if (!writes_allowed ||
+                !get_value(
+                    frame,
+                    std::static_pointer_cast<SplIrWriteInstruction>(inst)->src,
+                    value)) {
+                return false;
+            }
+            output.push_back(value);
+            return true;
+        }
+        case SplIrInstructionType::PHI:
+            frame.pc--;
+            return run_phis(frame);
+        default:
+            // reads depend on the input, and a function instruction is only
+            // reached by falling off the end of the previous function
+            return false;
+        }
+    }
+
+  public:
+    // values written so far, running into a write fails unless allowed
+    bool writes_allowed = false;
+    std::vector<int> output;
+
+    SplIrEvaluator(SplIrModule &ir_module, long fuel)
+        : ir_module(ir_module), fuel(fuel) {
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+            if ((*it)->type == SplIrInstructionType::FUNCTION) {
+                entries[std::static_pointer_cast<SplIrFunctionInstruction>(*it)
+                            ->func->repr] = it;
+            } else if ((*it)->type == SplIrInstructionType::LABEL) {
+                labels[std::static_pointer_cast<SplIrLabelInstruction>(*it)
+                           ->label->repr] = it;
+            }
+        }
+    }
+
+    // run the function on arguments given first to last, fails once the
+    // fuel left runs out, which is shared by all calls
+    bool call(const std::string &func_name, const std::vector<int> &args,
+              int &result) {
+        frames.clear();
+        if (!enter(func_name, std::vector<int>(args.rbegin(), args.rend()))) {
+            return false;
+        }
+        while (!frames.empty()) {
+            if (!step(result)) {
+                frames.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+class SplIrCallEvaluation {
+  private:
+    SplIrModule &ir_module;
+    SplIrCallGraph call_graph;
+    SplIrFunctionSummaries summaries;
+    // results by callee and arguments, failed evaluations are not retried
+    std::map<std::pair<std::string, std::vector<int>>, std::optional<int>>
+        results;
+
+    std::optional<int> evaluate(const std::string &func_name,
+                                const std::vector<int> &args) {
+        auto key = std::make_pair(func_name, args);
+        auto it = results.find(key);
+        if (it != results.end()) {
+            return it->second;
+        }
+        // memory is not shared across calls, each one has its own fuel
+        SplIrEvaluator evaluator(ir_module, SPL_IR_EVALUATION_FUEL);
+        std::optional<int> result;
+        int value;
+        if (evaluator.call(func_name, args, value)) {
+            result = value;
+        }
+        results[key] = result;
+        return result;
+    }
+
+  public:
+    explicit SplIrCallEvaluation(SplIrModule &ir_module)
+        : ir_module(ir_module),
+          call_graph(ir_module.analyses().get_call_graph()),
+          summaries(ir_module.analyses().get_function_summaries()) {}
+
+    bool run() {
+        bool changed = false;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+            if ((*it)->type != SplIrInstructionType::ASSIGN_CALL) {
+                continue;
+            }
+            auto &func_name =
+                std::static_pointer_cast<SplIrAssignCallInstruction>(*it)
+                    ->func->repr;
+            if (!call_graph.is_defined(func_name) ||
+                !summaries.get_summary(func_name).is_side_effect_free()) {
+                continue;
+            }
+            auto arg_its = spl_ir_get_call_args(ir_module, it);
+            std::vector<int> args;
+            for (auto arg_it : arg_its) {
+                int value;
+                if (!spl_ir_get_constant(
+                        std::static_pointer_cast<SplIrArgInstruction>(*arg_it)
+                            ->arg,
+                        value)) {
+                    break;
+                }
+                args.push_back(value);
+            }
+            if (args.size() < arg_its.size()) {
+                continue;
+            }
+            auto result = evaluate(func_name, args);
+            if (!result.has_value()) {
+                continue;
+            }
+            for (auto arg_it : arg_its) {
+                ir_module.erase_instruction_in_place(arg_it);
+            }
+            ir_module.replace_instruction(
+                it, std::make_shared<SplIrAssignInstruction>(
+                        *(*it)->def(),
+                        spl_ir_make_constant(ir_module, result.value())));
+            changed = true;
+        }
+        return changed;
+    }
+};
+
+bool evaluate_constant_calls(SplIrModule &ir_module) {
+    return SplIrCallEvaluation(ir_module).run();
+}
+
+bool evaluate_program(SplIrModule &ir_module, long fuel) {
+    auto it_main = std::find_if(
+        ir_module.ir.begin(), ir_module.ir.end(), [](const auto &inst) {
+            return inst->type == SplIrInstructionType::FUNCTION &&
+                   std::static_pointer_cast<SplIrFunctionInstruction>(inst)
+                           ->func->repr == "main";
+        });
+    if (it_main == ir_module.ir.end()) {
+        return false;
+    }
+    SplIrEvaluator evaluator(ir_module, fuel);
+    evaluator.writes_allowed = true;
+    int result;
+    if (!evaluator.call("main", {}, result)) {
+        return false;
+    }
+    SplIrInstructionList residual{*it_main};
+    for (auto value : evaluator.output) {
+        residual.push_back(std::make_shared<SplIrWriteInstruction>(
+            spl_ir_make_constant(ir_module, value)));
+    }
+    residual.push_back(std::make_shared<SplIrReturnInstruction>(
+        spl_ir_make_constant(ir_module, result)));
+    ir_module.ir = std::move(residual);
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+class SplIrMemoization {
+  private:
+    // each entry holds a flag telling whether it is filled, then the result
+    static constexpr int entry_size = 8;
+
+    SplIrModule &ir_module;
+    int entries;
+    SplIrCallGraph call_graph;
+    SplIrFunctionSummaries summaries;
+
+    std::shared_ptr<SplIrInstruction>
+    make_if_goto(const std::shared_ptr<SplIrOperand> &lhs,
+                 const std::shared_ptr<SplIrOperand> &rhs,
+                 SplIrIfGotoInstruction::Relop relop,
+                 const std::shared_ptr<SplIrOperand> &label) {
+        auto inst = std::make_shared<SplIrIfGotoInstruction>(lhs, rhs, relop);
+        inst->patch(label);
+        return inst;
+    }
+
+    // the calls of the function to itself, none if some of them does not
+    // pass a single argument
+    std::vector<SplIrInstructionList::iterator>
+    get_self_calls(const std::shared_ptr<SplIrOperand> &func,
+                   SplIrInstructionList::iterator body,
+                   SplIrInstructionList::iterator end) {
+        std::vector<SplIrInstructionList::iterator> calls;
+        for (auto it = body; it != end; it++) {
+            if ((*it)->type != SplIrInstructionType::ASSIGN_CALL ||
+                std::static_pointer_cast<SplIrAssignCallInstruction>(*it)
+                        ->func != func) {
+                continue;
+            }
+            if (spl_ir_get_call_args(ir_module, it).size() != 1) {
+                return {};
+            }
+            calls.push_back(it);
+        }
+        return calls;
+    }
+
+    // a function taking the name of the original one, which clears the
+    // entries up to its argument and passes the table on
+    void insert_wrapper(SplIrInstructionList::iterator pos,
+                        const std::shared_ptr<SplIrOperand> &func,
+                        const std::shared_ptr<SplIrOperand> &memo_func) {
+        auto param = ir_module.var_counter->next();
+        auto table = ir_module.tmp_counter->next();
+        auto address = ir_module.var_counter->next();
+        auto limit = ir_module.var_counter->next();
+        auto index = ir_module.var_counter->next();
+        auto offset = ir_module.tmp_counter->next();
+        auto slot = ir_module.tmp_counter->next();
+        auto result = ir_module.tmp_counter->next();
+        auto bounded = ir_module.label_counter->next();
+        auto clear = ir_module.label_counter->next();
+        auto call = ir_module.label_counter->next();
+        auto zero = spl_ir_make_constant(ir_module, 0);
+        auto one = spl_ir_make_constant(ir_module, 1);
+        auto size = spl_ir_make_constant(ir_module, entries);
+        SplIrInstructionList wrapper{
+            std::make_shared<SplIrFunctionInstruction>(func),
+            std::make_shared<SplIrParamInstruction>(param),
+            std::make_shared<SplIrDecInstruction>(table,
+                                                  entries * entry_size),
+            std::make_shared<SplIrAssignAddressInstruction>(address, table),
+            std::make_shared<SplIrAssignAddInstruction>(limit, param, one),
+            make_if_goto(limit, size, SplIrIfGotoInstruction::LE, bounded),
+            std::make_shared<SplIrAssignInstruction>(limit, size),
+            std::make_shared<SplIrLabelInstruction>(bounded),
+            std::make_shared<SplIrAssignInstruction>(index, zero),
+            make_if_goto(index, limit, SplIrIfGotoInstruction::GE, call),
+            std::make_shared<SplIrLabelInstruction>(clear),
+            std::make_shared<SplIrAssignMulInstruction>(
+                offset, index, spl_ir_make_constant(ir_module, entry_size)),
+            std::make_shared<SplIrAssignAddInstruction>(slot, address, offset),
+            std::make_shared<SplIrAssignDerefDstInstruction>(slot, zero),
+            std::make_shared<SplIrAssignAddInstruction>(index, index, one),
+            make_if_goto(index, limit, SplIrIfGotoInstruction::LT, clear),
+            std::make_shared<SplIrLabelInstruction>(call),
+            std::make_shared<SplIrArgInstruction>(limit),
+            std::make_shared<SplIrArgInstruction>(address),
+            std::make_shared<SplIrArgInstruction>(param),
+            std::make_shared<SplIrAssignCallInstruction>(result, memo_func),
+            std::make_shared<SplIrReturnInstruction>(result)};
+        ir_module.ir.splice(pos, wrapper);
+    }
+
+    bool memoize(SplIrInstructionList::iterator entry,
+                 SplIrInstructionList::iterator end) {
+        auto func = std::static_pointer_cast<SplIrFunctionInstruction>(*entry)
+                        ->func;
+        auto body = std::next(entry);
+        if (func->repr == "main" || body == end ||
+            (*body)->type != SplIrInstructionType::PARAM ||
+            std::next(body) == end ||
+            (*std::next(body))->type == SplIrInstructionType::PARAM ||
+            !summaries.get_summary(func->repr).is_pure()) {
+            return false;
+        }
+        auto param =
+            std::static_pointer_cast<SplIrParamInstruction>(*body)->param;
+        body++;
+        // a single call to itself gains nothing from a table filled anew
+        // by each outermost call
+        auto calls = get_self_calls(func, body, end);
+        if (calls.size() < 2) {
+            return false;
+        }
+        std::string name;
+        for (int k = 1; name.empty() || call_graph.is_defined(name); k++) {
+            name = func->repr + "_memo" + (k > 1 ? std::to_string(k) : "");
+        }
+        auto memo_func = ir_module.get_or_make_function_operand_by_name(name);
+        insert_wrapper(entry, func, memo_func);
+        *entry = std::make_shared<SplIrFunctionInstruction>(memo_func);
+        // the table and the number of its entries in use follow the argument
+        auto address = ir_module.var_counter->next();
+        auto limit = ir_module.var_counter->next();
+        ir_module.ir.insert(body,
+                            std::make_shared<SplIrParamInstruction>(address));
+        ir_module.ir.insert(body,
+                            std::make_shared<SplIrParamInstruction>(limit));
+        for (auto call : calls) {
+            auto first_arg = spl_ir_get_call_args(ir_module, call).back();
+            ir_module.ir.insert(first_arg,
+                                std::make_shared<SplIrArgInstruction>(limit));
+            ir_module.ir.insert(
+                first_arg, std::make_shared<SplIrArgInstruction>(address));
+            *call = std::make_shared<SplIrAssignCallInstruction>(
+                *(*call)->def(), memo_func);
+        }
+        // the entry of the argument, null if it is out of the table, whose
+        // result is returned right away once filled
+        auto slot = ir_module.var_counter->next();
+        auto offset = ir_module.tmp_counter->next();
+        auto filled = ir_module.tmp_counter->next();
+        auto value_slot = ir_module.tmp_counter->next();
+        auto value = ir_module.tmp_counter->next();
+        auto compute = ir_module.label_counter->next();
+        auto zero = spl_ir_make_constant(ir_module, 0);
+        SplIrInstructionList lookup{
+            std::make_shared<SplIrAssignInstruction>(slot, zero),
+            make_if_goto(param, zero, SplIrIfGotoInstruction::LT, compute),
+            make_if_goto(param, limit, SplIrIfGotoInstruction::GE, compute),
+            std::make_shared<SplIrAssignMulInstruction>(
+                offset, param, spl_ir_make_constant(ir_module, entry_size)),
+            std::make_shared<SplIrAssignAddInstruction>(slot, address, offset),
+            std::make_shared<SplIrAssignDerefSrcInstruction>(filled, slot),
+            make_if_goto(filled, zero, SplIrIfGotoInstruction::EQ, compute),
+            std::make_shared<SplIrAssignAddInstruction>(
+                value_slot, slot, spl_ir_make_constant(ir_module, 4)),
+            std::make_shared<SplIrAssignDerefSrcInstruction>(value,
+                                                             value_slot),
+            std::make_shared<SplIrReturnInstruction>(value),
+            std::make_shared<SplIrLabelInstruction>(compute)};
+        ir_module.ir.splice(body, lookup);
+        // results are stored before being returned
+        for (auto it = body; it != end; it++) {
+            if ((*it)->type != SplIrInstructionType::RETURN) {
+                continue;
+            }
+            auto result =
+                std::static_pointer_cast<SplIrReturnInstruction>(*it)->src;
+            auto skip = ir_module.label_counter->next();
+            auto result_slot = ir_module.tmp_counter->next();
+            SplIrInstructionList store{
+                make_if_goto(slot, zero, SplIrIfGotoInstruction::EQ, skip),
+                std::make_shared<SplIrAssignDerefDstInstruction>(
+                    slot, spl_ir_make_constant(ir_module, 1)),
+                std::make_shared<SplIrAssignAddInstruction>(
+                    result_slot, slot, spl_ir_make_constant(ir_module, 4)),
+                std::make_shared<SplIrAssignDerefDstInstruction>(result_slot,
+                                                                 result),
+                std::make_shared<SplIrLabelInstruction>(skip)};
+            ir_module.ir.splice(it, store);
+        }
+        return true;
+    }
+
+  public:
+    SplIrMemoization(SplIrModule &ir_module, int entries)
+        : ir_module(ir_module), entries(entries),
+          call_graph(ir_module.analyses().get_call_graph()),
+          summaries(ir_module.analyses().get_function_summaries()) {}
+
+    bool run() {
+        bool changed = false;
+        for (auto it = ir_module.ir.begin(); it != ir_module.ir.end();) {
+            auto end = spl_ir_get_function_end(ir_module, it);
+            changed |= memoize(it, end);
+            it = end;
+        }
+        return changed;
+    }
+};
+
+bool memoize_functions(SplIrModule &ir_module, int entries) {
+    if (entries <= 0 || !SplIrMemoization(ir_module, entries).run()) {
+        return false;
+    }
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+    return true;
+}
+
+#endif /* SPL_IR_OPTIMIZER_HPP */
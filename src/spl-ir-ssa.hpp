@@ -0,0 +1,679 @@
+#ifndef SPL_IR_SSA_HPP
+#define SPL_IR_SSA_HPP
+
+#include "spl-ir-analysis.hpp"
+#include "spl-ir.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// l-value operands allowed to be renamed, they are only read and written
+// directly (never address-taken) by instructions of a single function
+SplIrOperandSet get_ssa_candidates(SplIrModule &ir_module);
+
+// rename candidates so that each one is defined exactly once, definitions
+// meeting at a join point are merged by a phi instruction, phi instructions
+// are placed on iterated dominance frontiers where the operand is live
+// (pruned ssa of Cytron et al.)
+void construct_ssa(SplIrModule &ir_module);
+
+// rename variables a pass introduces into an ir already in ssa form, the
+// same way as construct_ssa does, leaving other operands untouched
+void promote_to_ssa(SplIrModule &ir_module, const SplIrOperandSet &candidates);
+
+// lower phi instructions to copies at the end of predecessors, then coalesce
+// copy related operands whose live ranges do not interfere so that the copies
+// vanish, basic blocks are rebuilt afterwards
+void destruct_ssa(SplIrModule &ir_module);
+
+// drop an edge of the control flow graph without rebuilding basic blocks,
+// incoming values of phi instructions along the edge are dropped as well
+void remove_control_flow_edge(SplIrModule &ir_module,
+                              const std::shared_ptr<SplIrBasicBlock> &from,
+                              const std::shared_ptr<SplIrBasicBlock> &to);
+
+// a fresh temporary for passes working on ssa form
+std::shared_ptr<SplIrOperand> make_ssa_temporary(SplIrModule &ir_module);
+
+// whether the operand is renamed by ssa construction, it is then defined once
+// and keeps its value everywhere the definition dominates
+bool is_ssa_value(SplIrModule &ir_module,
+                  const std::shared_ptr<SplIrOperand> &op);
+
+// for debug
+void debug_print_ssa(SplIrModule &ir_module);
+
+static bool
+spl_ir_is_referenced_directly(std::shared_ptr<SplIrInstruction> &inst,
+                              const std::shared_ptr<SplIrOperand> &op) {
+    auto def = inst->def();
+    if (def != nullptr && *def == op) {
+        return true;
+    }
+    for (auto use : inst->uses()) {
+        if (*use == op) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SplIrOperandSet get_ssa_candidates(SplIrModule &ir_module) {
+    std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>> owner;
+    std::unordered_map<SplIrOperand *, std::shared_ptr<SplIrOperand>> operands;
+    std::unordered_set<SplIrOperand *> excluded;
+    std::shared_ptr<SplIrOperand> current_func = nullptr;
+    for (auto &inst : ir_module.ir) {
+        if (inst->type == SplIrInstructionType::FUNCTION) {
+            current_func =
+                std::static_pointer_cast<SplIrFunctionInstruction>(inst)->func;
+        }
+        for (auto operand : inst->operands) {
+            auto &op = operand.get();
+            if (!op->is_l_value()) {
+                continue;
+            }
+            operands[op.get()] = op;
+            // address-taken, declared, or used by another function
+            if (current_func == nullptr ||
+                !spl_ir_is_referenced_directly(inst, op)) {
+                excluded.insert(op.get());
+                continue;
+            }
+            auto it = owner.find(op.get());
+            if (it == owner.end()) {
+                owner[op.get()] = current_func;
+            } else if (it->second != current_func) {
+                excluded.insert(op.get());
+            }
+        }
+    }
+    SplIrOperandSet result;
+    for (auto &pair : operands) {
+        if (excluded.count(pair.first) == 0) {
+            result.insert(pair.second);
+        }
+    }
+    return result;
+}
+
+class SplIrSsaBuilder {
+  private:
+    SplIrModule &ir_module;
+    const SplIrOperandSet &candidates;
+    const SplIrFunction &function;
+    const SplIrReversePostOrder &rpo;
+    const SplIrDominatorTree &dom;
+    const SplIrLiveness &liveness;
+    // operands renamed by each phi instruction
+    std::unordered_map<SplIrInstruction *, std::shared_ptr<SplIrOperand>>
+        phi_origin;
+    // current version of each candidate while walking the dominator tree
+    std::unordered_map<SplIrOperand *,
+                       std::vector<std::shared_ptr<SplIrOperand>>>
+        versions;
+
+    std::shared_ptr<SplIrOperand>
+    current_version(const std::shared_ptr<SplIrOperand> &op) {
+        auto it = versions.find(op.get());
+        if (it == versions.end() || it->second.empty()) {
+            // read before any definition, the value is undefined anyway
+            return op;
+        }
+        return it->second.back();
+    }
+
+    std::shared_ptr<SplIrOperand>
+    new_version(const std::shared_ptr<SplIrOperand> &op) {
+        auto version = op->is_l_value_variable()
+                           ? ir_module.var_counter->next()
+                           : ir_module.tmp_counter->next();
+        versions[op.get()].push_back(version);
+        ir_module.ssa_origins[version->repr] = op;
+        return version;
+    }
+
+    void insert_phi(const std::shared_ptr<SplIrBasicBlock> &basic_block,
+                    const std::shared_ptr<SplIrOperand> &op) {
+        // phi instructions go right after the label
+        auto pos = basic_block->head;
+        if ((*pos)->type == SplIrInstructionType::LABEL) {
+            pos++;
+        }
+        auto phi = std::make_shared<SplIrPhiInstruction>(op);
+        ir_module.insert_instruction(pos, phi, basic_block);
+        phi_origin[phi.get()] = op;
+    }
+
+    void rename(const std::shared_ptr<SplIrBasicBlock> &basic_block) {
+        std::vector<SplIrOperand *> defined;
+        auto end = ir_module.ir.end();
+        for (auto it = basic_block->head;
+             it != end && (*it)->parent == basic_block; it++) {
+            if ((*it)->type != SplIrInstructionType::PHI) {
+                for (auto use : (*it)->uses()) {
+                    if (candidates.count(*use) > 0) {
+                        *use = current_version(*use);
+                    }
+                }
+            }
+            auto def = (*it)->def();
+            if (def != nullptr && candidates.count(*def) > 0) {
+                defined.push_back(def->get());
+                *def = new_version(*def);
+            }
+        }
+        for (auto &succ : basic_block->successors) {
+            if (!function.contains(succ)) {
+                continue;
+            }
+            for (auto it = succ->head; it != end && (*it)->parent == succ;
+                 it++) {
+                if ((*it)->type != SplIrInstructionType::PHI) {
+                    continue;
+                }
+                auto phi = std::static_pointer_cast<SplIrPhiInstruction>(*it);
+                auto origin = phi_origin.find(phi.get());
+                // a successor reached along two edges gets a single incoming,
+                // phi instructions placed earlier already have theirs
+                if (origin == phi_origin.end() ||
+                    (!phi->incomings.empty() &&
+                     phi->incomings.back().first == basic_block)) {
+                    continue;
+                }
+                phi->add_incoming(basic_block, current_version(origin->second));
+            }
+        }
+        for (auto &child : dom.get_children(basic_block)) {
+            rename(child);
+        }
+        for (auto op : defined) {
+            versions[op].pop_back();
+        }
+    }
+
+  public:
+    SplIrSsaBuilder(SplIrModule &ir_module, const SplIrOperandSet &candidates,
+                    const SplIrFunction &function,
+                    const SplIrReversePostOrder &rpo,
+                    const SplIrDominatorTree &dom,
+                    const SplIrLiveness &liveness)
+        : ir_module(ir_module), candidates(candidates), function(function),
+          rpo(rpo), dom(dom), liveness(liveness) {}
+
+    void build() {
+        if (rpo.order.empty()) {
+            return;
+        }
+        // basic blocks defining each candidate, candidates are kept in order
+        // of their first definition so that the output is deterministic
+        std::vector<std::shared_ptr<SplIrOperand>> defined;
+        std::unordered_map<SplIrOperand *, SplIrBasicBlockVector> def_sites;
+        auto end = ir_module.ir.end();
+        for (auto &basic_block : rpo.order) {
+            for (auto it = basic_block->head;
+                 it != end && (*it)->parent == basic_block; it++) {
+                auto def = (*it)->def();
+                if (def == nullptr || candidates.count(*def) == 0) {
+                    continue;
+                }
+                auto &sites = def_sites[def->get()];
+                if (sites.empty()) {
+                    defined.push_back(*def);
+                }
+                if (sites.empty() || sites.back() != basic_block) {
+                    sites.push_back(basic_block);
+                }
+            }
+        }
+        for (auto &op : defined) {
+            std::unordered_set<SplIrBasicBlock *> has_phi;
+            auto worklist = def_sites[op.get()];
+            while (!worklist.empty()) {
+                auto basic_block = worklist.back();
+                worklist.pop_back();
+                for (auto &join : dom.get_frontier(basic_block)) {
+                    if (!has_phi.insert(join.get()).second ||
+                        !liveness.is_live_in(join, op)) {
+                        continue;
+                    }
+                    insert_phi(join, op);
+                    // the phi instruction is a new definition
+                    worklist.push_back(join);
+                }
+            }
+        }
+        rename(rpo.order.front());
+    }
+};
+
+static void spl_ir_build_ssa(SplIrModule &ir_module,
+                             const SplIrOperandSet &candidates) {
+    auto &manager = ir_module.analyses();
+    for (auto &function : manager.get_functions()) {
+        SplIrSsaBuilder builder(
+            ir_module, candidates, *function,
+            manager.get_reverse_post_order(function->name),
+            manager.get_dominator_tree(function->name),
+            manager.get_liveness(function->name));
+        builder.build();
+    }
+    ir_module.rebuild_use_lists();
+    // the control flow graph is untouched
+    manager.invalidate(SPL_IR_ANALYSIS_DATAFLOW);
+}
+
+void construct_ssa(SplIrModule &ir_module) {
+    if (ir_module.in_ssa_form) {
+        return;
+    }
+    ir_module.in_ssa_form = true;
+    spl_ir_build_ssa(ir_module, get_ssa_candidates(ir_module));
+}
+
+void promote_to_ssa(SplIrModule &ir_module, const SplIrOperandSet &candidates) {
+    if (!ir_module.in_ssa_form) {
+        throw std::runtime_error("Promotion to ssa requires ssa form");
+    }
+    // liveness is computed again with the candidates in place
+    ir_module.analyses().invalidate(SPL_IR_ANALYSIS_DATAFLOW);
+    spl_ir_build_ssa(ir_module, candidates);
+}
+
+// returns the copies inserted
+static std::unordered_set<SplIrInstruction *>
+spl_ir_insert_phi_copies(SplIrModule &ir_module) {
+    std::unordered_set<SplIrInstruction *> copies;
+    for (auto it = ir_module.ir.begin(); it != ir_module.ir.end(); it++) {
+        if ((*it)->type != SplIrInstructionType::PHI) {
+            continue;
+        }
+        auto phi = std::static_pointer_cast<SplIrPhiInstruction>(*it);
+        // the incoming values are copied to a fresh operand before leaving
+        // each predecessor, the phi instruction becomes a copy from it, so
+        // that phi instructions of a basic block read their operands in
+        // parallel; the fresh operand is dead along other successors of a
+        // predecessor, so critical edges need no splitting
+        auto incoming = phi->dst->is_l_value_variable()
+                            ? ir_module.var_counter->next()
+                            : ir_module.tmp_counter->next();
+        auto it_origin = ir_module.ssa_origins.find(phi->dst->repr);
+        if (it_origin != ir_module.ssa_origins.end()) {
+            ir_module.ssa_origins[incoming->repr] = it_origin->second;
+        }
+        for (auto &pair : phi->incomings) {
+            auto pos = ir_module.get_basic_block_end(pair.first);
+            auto last = std::prev(pos);
+            if ((*last)->type == SplIrInstructionType::GOTO ||
+                (*last)->type == SplIrInstructionType::IF_GOTO) {
+                pos = last;
+            }
+            auto copy =
+                std::make_shared<SplIrAssignInstruction>(incoming, pair.second);
+            ir_module.insert_instruction(pos, copy, pair.first);
+            copies.insert(copy.get());
+        }
+        auto copy =
+            std::make_shared<SplIrAssignInstruction>(phi->dst, incoming);
+        ir_module.replace_instruction(it, copy);
+        copies.insert(copy.get());
+    }
+    return copies;
+}
+
+// operand names come from counters, so the smallest number is the oldest
+// operand, which is the name before ssa construction if there is one
+static bool spl_ir_is_preferred_name(const std::shared_ptr<SplIrOperand> &a,
+                                     const std::shared_ptr<SplIrOperand> &b) {
+    if (a->type != b->type) {
+        return a->is_l_value_variable();
+    }
+    return std::stoi(a->repr.substr(1)) < std::stoi(b->repr.substr(1));
+}
+
+class SplIrCopyCoalescer {
+  private:
+    SplIrModule &ir_module;
+    const SplIrOperandSet &candidates;
+    const SplIrReversePostOrder &rpo;
+    const SplIrLiveness &liveness;
+    // union find over operand ids of liveness
+    std::vector<size_t> leader;
+    std::vector<std::vector<size_t>> members;
+    // interfering operands of every member of a class, kept by its leader
+    std::vector<std::unordered_set<size_t>> interference;
+
+    size_t find(size_t id) {
+        while (leader[id] != id) {
+            leader[id] = leader[leader[id]];
+            id = leader[id];
+        }
+        return id;
+    }
+
+    bool interferes(size_t a, size_t b) {
+        if (members[a].size() > members[b].size()) {
+            std::swap(a, b);
+        }
+        for (auto member : members[a]) {
+            if (interference[b].count(member) > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void unite(size_t a, size_t b) {
+        if (members[a].size() < members[b].size()) {
+            std::swap(a, b);
+        }
+        leader[b] = a;
+        members[a].insert(members[a].end(), members[b].begin(),
+                          members[b].end());
+        interference[a].insert(interference[b].begin(), interference[b].end());
+        members[b].clear();
+        interference[b].clear();
+    }
+
+    std::shared_ptr<SplIrOperand>
+    get_origin(const std::shared_ptr<SplIrOperand> &op) {
+        auto it = ir_module.ssa_origins.find(op->repr);
+        return it == ir_module.ssa_origins.end() ? op : it->second;
+    }
+
+    // a class is named after the operand its members are renamed from, unless
+    // the name is taken by another class, then after its oldest member
+    std::vector<std::shared_ptr<SplIrOperand>> name_classes() {
+        size_t n = liveness.numbering.size();
+        std::vector<std::shared_ptr<SplIrOperand>> origin(n), oldest(n),
+            names(n);
+        for (size_t i = 0; i < n; i++) {
+            size_t root = find(i);
+            auto &op = liveness.numbering.operands[i];
+            auto op_origin = get_origin(op);
+            if (origin[root] == nullptr ||
+                spl_ir_is_preferred_name(op_origin, origin[root])) {
+                origin[root] = op_origin;
+            }
+            if (oldest[root] == nullptr ||
+                spl_ir_is_preferred_name(op, oldest[root])) {
+                oldest[root] = op;
+            }
+        }
+        std::unordered_set<SplIrOperand *> claimed;
+        for (size_t i = 0; i < n; i++) {
+            if (find(i) != i) {
+                continue;
+            }
+            auto id = liveness.numbering.find(origin[i]);
+            if (claimed.count(origin[i].get()) == 0 &&
+                (id == SplIrOperandNumbering::npos || find(id) == i)) {
+                names[i] = origin[i];
+            } else {
+                names[i] = oldest[i];
+            }
+            claimed.insert(names[i].get());
+        }
+        for (size_t i = 0; i < n; i++) {
+            names[i] = names[find(i)];
+        }
+        return names;
+    }
+
+    std::vector<SplIrInstructionList::iterator>
+    get_instructions(const std::shared_ptr<SplIrBasicBlock> &basic_block) {
+        std::vector<SplIrInstructionList::iterator> result;
+        for (auto it = basic_block->head;
+             it != ir_module.ir.end() && (*it)->parent == basic_block; it++) {
+            result.push_back(it);
+        }
+        return result;
+    }
+
+    // the coalescable copy instruction is dst := src
+    bool get_copy(const std::shared_ptr<SplIrInstruction> &inst, size_t &dst,
+                  size_t &src) {
+        if (inst->type != SplIrInstructionType::ASSIGN) {
+            return false;
+        }
+        auto assign = std::static_pointer_cast<SplIrAssignInstruction>(inst);
+        if (candidates.count(assign->dst) == 0 ||
+            candidates.count(assign->src) == 0) {
+            return false;
+        }
+        dst = liveness.numbering.find(assign->dst);
+        src = liveness.numbering.find(assign->src);
+        return true;
+    }
+
+    // operands holding the value a copy is about to take, copies of the same
+    // source in a row do not interfere with each other
+    std::vector<std::unordered_set<size_t>> get_copied_values(
+        const std::vector<SplIrInstructionList::iterator> &insts) {
+        size_t n = liveness.numbering.size();
+        std::vector<std::unordered_set<size_t>> result(insts.size());
+        std::unordered_map<size_t, size_t> copy_of;
+        for (size_t i = 0; i < insts.size(); i++) {
+            size_t dst, src;
+            bool is_copy = get_copy(*insts[i], dst, src);
+            if (is_copy) {
+                auto it = copy_of.find(src);
+                src = it == copy_of.end() ? src : it->second;
+                result[i].insert(src);
+                for (auto &[id, value] : copy_of) {
+                    if (value == src) {
+                        result[i].insert(id);
+                    }
+                }
+            }
+            auto def = (*insts[i])->def();
+            size_t d = def == nullptr ? n : liveness.numbering.find(*def);
+            for (auto it = copy_of.begin(); it != copy_of.end();) {
+                it = it->second == d ? copy_of.erase(it) : std::next(it);
+            }
+            copy_of.erase(d);
+            if (is_copy && dst != src) {
+                copy_of[dst] = src;
+            }
+        }
+        return result;
+    }
+
+    void build_interference() {
+        for (auto &basic_block : rpo.order) {
+            auto live = liveness.live_out.at(basic_block.get());
+            auto insts = get_instructions(basic_block);
+            auto copied_values = get_copied_values(insts);
+            for (size_t i = insts.size(); i-- > 0;) {
+                auto &inst = *insts[i];
+                if (auto def = inst->def()) {
+                    size_t d = liveness.numbering.find(*def);
+                    // the source of a copy and other copies of it hold the
+                    // same value, they do not interfere here
+                    live.for_each([&](size_t id) {
+                        if (id != d && copied_values[i].count(id) == 0) {
+                            interference[d].insert(id);
+                            interference[id].insert(d);
+                        }
+                    });
+                    live.reset(d);
+                }
+                for (auto use : inst->uses()) {
+                    auto id = liveness.numbering.find(*use);
+                    if (id != SplIrOperandNumbering::npos) {
+                        live.set(id);
+                    }
+                }
+            }
+        }
+    }
+
+  public:
+    SplIrCopyCoalescer(SplIrModule &ir_module,
+                       const SplIrOperandSet &candidates,
+                       const SplIrReversePostOrder &rpo,
+                       const SplIrLiveness &liveness)
+        : ir_module(ir_module), candidates(candidates), rpo(rpo),
+          liveness(liveness) {}
+
+    // copies lowered from phi instructions are coalesced first, other copies
+    // are coalesced afterwards if still possible; returns copies made
+    // redundant, they are left in place for the caller
+    std::vector<SplIrInstructionList::iterator>
+    coalesce(const std::unordered_set<SplIrInstruction *> &phi_copies) {
+        size_t n = liveness.numbering.size();
+        leader.resize(n);
+        members.resize(n);
+        interference.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            leader[i] = i;
+            members[i].push_back(i);
+        }
+        build_interference();
+        for (int round = 0; round < 2; round++) {
+            for (auto &basic_block : rpo.order) {
+                for (auto it : get_instructions(basic_block)) {
+                    size_t dst, src;
+                    if ((phi_copies.count(it->get()) > 0) != (round == 0) ||
+                        !get_copy(*it, dst, src)) {
+                        continue;
+                    }
+                    dst = find(dst);
+                    src = find(src);
+                    if (dst != src && !interferes(dst, src)) {
+                        unite(dst, src);
+                    }
+                }
+            }
+        }
+        // versions of an operand not coalesced by copies still share its
+        // name wherever they do not interfere
+        std::unordered_map<SplIrOperand *, size_t> origin_class;
+        for (size_t i = 0; i < n; i++) {
+            auto origin = get_origin(liveness.numbering.operands[i]);
+            auto it = origin_class.find(origin.get());
+            if (it == origin_class.end()) {
+                origin_class[origin.get()] = i;
+                continue;
+            }
+            size_t a = find(it->second), b = find(i);
+            if (a != b && !interferes(a, b)) {
+                unite(a, b);
+            }
+        }
+        auto names = name_classes();
+        std::vector<SplIrInstructionList::iterator> redundant;
+        for (auto &basic_block : rpo.order) {
+            for (auto it : get_instructions(basic_block)) {
+                std::vector<std::shared_ptr<SplIrOperand> *> refs =
+                    (*it)->uses();
+                if (auto def = (*it)->def()) {
+                    refs.push_back(def);
+                }
+                for (auto ref : refs) {
+                    if (candidates.count(*ref) == 0) {
+                        continue;
+                    }
+                    *ref = names[liveness.numbering.find(*ref)];
+                }
+                if ((*it)->type == SplIrInstructionType::ASSIGN) {
+                    auto assign =
+                        std::static_pointer_cast<SplIrAssignInstruction>(*it);
+                    if (assign->dst == assign->src) {
+                        redundant.push_back(it);
+                    }
+                }
+            }
+        }
+        return redundant;
+    }
+};
+
+void destruct_ssa(SplIrModule &ir_module) {
+    if (!ir_module.in_ssa_form) {
+        return;
+    }
+    auto phi_copies = spl_ir_insert_phi_copies(ir_module);
+    auto &manager = ir_module.analyses();
+    manager.invalidate(SPL_IR_ANALYSIS_DATAFLOW);
+    auto candidates = get_ssa_candidates(ir_module);
+    std::vector<SplIrInstructionList::iterator> redundant;
+    for (auto &function : manager.get_functions()) {
+        SplIrCopyCoalescer coalescer(
+            ir_module, candidates,
+            manager.get_reverse_post_order(function->name),
+            manager.get_liveness(function->name));
+        auto copies = coalescer.coalesce(phi_copies);
+        redundant.insert(redundant.end(), copies.begin(), copies.end());
+    }
+    for (auto it : redundant) {
+        ir_module.ir.erase(it);
+    }
+    ir_module.in_ssa_form = false;
+    ir_module.ssa_origins.clear();
+    ir_module.rebuild_use_lists();
+    ir_module.rebuild_basic_blocks();
+}
+
+void remove_control_flow_edge(SplIrModule &ir_module,
+                              const std::shared_ptr<SplIrBasicBlock> &from,
+                              const std::shared_ptr<SplIrBasicBlock> &to) {
+    auto &succs = from->successors;
+    auto &preds = to->predecessors;
+    auto it_succ = std::find(succs.begin(), succs.end(), to);
+    auto it_pred = std::find(preds.begin(), preds.end(), from);
+    if (it_succ == succs.end() || it_pred == preds.end()) {
+        return;
+    }
+    succs.erase(it_succ);
+    preds.erase(it_pred);
+    // a conditional branch to the next basic block has two edges to it
+    if (std::find(succs.begin(), succs.end(), to) != succs.end()) {
+        return;
+    }
+    for (auto it = to->head; it != ir_module.ir.end() && (*it)->parent == to;
+         it++) {
+        if ((*it)->type != SplIrInstructionType::PHI) {
+            continue;
+        }
+        auto phi = std::static_pointer_cast<SplIrPhiInstruction>(*it);
+        for (auto it_incoming = phi->incomings.begin();
+             it_incoming != phi->incomings.end(); it_incoming++) {
+            if (it_incoming->first == from) {
+                auto value = &it_incoming->second;
+                phi->operands.remove_if(
+                    [&](auto &operand) { return &operand.get() == value; });
+                phi->incomings.erase(it_incoming);
+                break;
+            }
+        }
+    }
+}
+
+std::shared_ptr<SplIrOperand> make_ssa_temporary(SplIrModule &ir_module) {
+    auto op = ir_module.tmp_counter->next();
+    ir_module.ssa_origins[op->repr] = op;
+    return op;
+}
+
+bool is_ssa_value(SplIrModule &ir_module,
+                  const std::shared_ptr<SplIrOperand> &op) {
+    return ir_module.ssa_origins.count(op->repr) > 0;
+}
+
+void debug_print_ssa(SplIrModule &ir_module) {
+    // for debug
+    std::stringstream ss;
+    for (auto &inst : ir_module.ir) {
+        inst->print(ss);
+    }
+    std::cout << ss.str() << std::endl;
+}
+
+#endif /* SPL_IR_SSA_HPP */
@@ -7,6 +7,7 @@
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <optional>
@@ -46,7 +47,8 @@ enum class SplIrInstructionType {
     ASSIGN_CALL,
     PARAM,
     READ,
-    WRITE
+    WRITE,
+    PHI
 };
 
 class SplIrOperand;
@@ -63,6 +65,7 @@ using SplIrOperandName2Operand =
     std::unordered_map<std::string, std::shared_ptr<SplIrOperand>>;
 
 class SplIrModule;
+class SplIrAnalysisManager;
 
 class Patchable;
 
@@ -132,6 +135,10 @@ class SplIrInstruction {
     std::shared_ptr<SplIrBasicBlock> parent;
     explicit SplIrInstruction(SplIrInstructionType type) : type(type) {}
     virtual void print(std::stringstream &out) = 0;
+    /* the operand whose value is (re)defined, nullptr if there is none */
+    virtual std::shared_ptr<SplIrOperand> *def() { return nullptr; }
+    /* operands whose values are read, constants included */
+    virtual std::vector<std::shared_ptr<SplIrOperand> *> uses() { return {}; }
 };
 
 class SplIrLabelInstruction : public SplIrInstruction {
@@ -186,6 +193,10 @@ class SplIrAssignInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << dst->repr << " := " << src->repr << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src};
+    }
 };
 
 class SplIrAssignAddInstruction : public SplIrInstruction {
@@ -212,6 +223,10 @@ class SplIrAssignAddInstruction : public SplIrInstruction {
         out << dst->repr << " := " << src1->repr << " + " << src2->repr
             << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src1, &src2};
+    }
 };
 
 class SplIrAssignMinusInstruction : public SplIrInstruction {
@@ -238,6 +253,10 @@ class SplIrAssignMinusInstruction : public SplIrInstruction {
         out << dst->repr << " := " << src1->repr << " - " << src2->repr
             << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src1, &src2};
+    }
 };
 
 class SplIrAssignMulInstruction : public SplIrInstruction {
@@ -264,6 +283,10 @@ class SplIrAssignMulInstruction : public SplIrInstruction {
         out << dst->repr << " := " << src1->repr << " * " << src2->repr
             << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src1, &src2};
+    }
 };
 
 class SplIrAssignDivInstruction : public SplIrInstruction {
@@ -290,6 +313,10 @@ class SplIrAssignDivInstruction : public SplIrInstruction {
         out << dst->repr << " := " << src1->repr << " / " << src2->repr
             << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src1, &src2};
+    }
 };
 
 class SplIrAssignAddressInstruction : public SplIrInstruction {
@@ -313,6 +340,8 @@ class SplIrAssignAddressInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << dst->repr << " := &" << src->repr << std::endl;
     }
+    /* src is address-taken rather than read */
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
 };
 
 class SplIrAssignDerefSrcInstruction : public SplIrInstruction {
@@ -336,6 +365,10 @@ class SplIrAssignDerefSrcInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << dst->repr << " := *" << src->repr << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src};
+    }
 };
 
 class SplIrAssignDerefDstInstruction : public SplIrInstruction {
@@ -355,6 +388,10 @@ class SplIrAssignDerefDstInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << "*" << dst->repr << " := " << src->repr << std::endl;
     }
+    /* memory is written, dst only provides the address */
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&dst, &src};
+    }
 };
 
 class SplIrGotoInstruction : public SplIrInstruction, public Patchable {
@@ -421,6 +458,23 @@ class SplIrIfGotoInstruction : public SplIrInstruction, public Patchable {
         }
         throw std::runtime_error("Invalid relop");
     }
+    // the relop holding once both operands are swapped
+    static Relop swapped_relop(Relop relop) {
+        switch (relop) {
+        case EQ:
+        case NE:
+            return relop;
+        case LT:
+            return GT;
+        case LE:
+            return GE;
+        case GT:
+            return LT;
+        case GE:
+            return LE;
+        }
+        throw std::runtime_error("Invalid relop");
+    }
     static std::string relop_to_string(Relop relop) {
         switch (relop) {
         case EQ:
@@ -450,6 +504,8 @@ class SplIrIfGotoInstruction : public SplIrInstruction, public Patchable {
             throw std::runtime_error("IfGoto instruction must have value "
                                      "operands");
         }
+        operands.push_front(this->lhs);
+        operands.push_front(this->rhs);
     }
     SplIrIfGotoInstruction(std::shared_ptr<SplIrOperand> lhs,
                            std::shared_ptr<SplIrOperand> rhs, Relop relop)
@@ -459,6 +515,8 @@ class SplIrIfGotoInstruction : public SplIrInstruction, public Patchable {
             throw std::runtime_error("IfGoto instruction must have value "
                                      "operands");
         }
+        operands.push_front(this->lhs);
+        operands.push_front(this->rhs);
     }
 
     void patch(const std::shared_ptr<SplIrOperand> label) override {
@@ -477,6 +535,9 @@ class SplIrIfGotoInstruction : public SplIrInstruction, public Patchable {
         out << "IF " << lhs->repr << " " << relop_to_string(relop) << " "
             << rhs->repr << " GOTO " << label.value()->repr << std::endl;
     }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&lhs, &rhs};
+    }
 };
 
 class SplIrReturnInstruction : public SplIrInstruction {
@@ -493,6 +554,9 @@ class SplIrReturnInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << "RETURN " << src->repr << std::endl;
     }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src};
+    }
 };
 
 class SplIrDecInstruction : public SplIrInstruction {
@@ -530,6 +594,9 @@ class SplIrArgInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << "ARG " << arg->repr << std::endl;
     }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&arg};
+    }
 };
 
 class SplIrAssignCallInstruction : public SplIrInstruction {
@@ -553,6 +620,7 @@ class SplIrAssignCallInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << dst->repr << " := CALL " << func->repr << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
 };
 
 class SplIrParamInstruction : public SplIrInstruction {
@@ -569,6 +637,7 @@ class SplIrParamInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << "PARAM " << param->repr << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &param; }
 };
 
 class SplIrReadInstruction : public SplIrInstruction {
@@ -585,6 +654,7 @@ class SplIrReadInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << "READ " << dst->repr << std::endl;
     }
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
 };
 
 class SplIrWriteInstruction : public SplIrInstruction {
@@ -601,6 +671,46 @@ class SplIrWriteInstruction : public SplIrInstruction {
     void print(std::stringstream &out) override {
         out << "WRITE " << src->repr << std::endl;
     }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        return {&src};
+    }
+};
+
+// only exists while the ir is in ssa form, basic blocks must not be rebuilt in
+// the meantime as incoming values refer to them
+class SplIrPhiInstruction : public SplIrInstruction {
+  public:
+    std::shared_ptr<SplIrOperand> dst;
+    // one incoming value for each predecessor basic block
+    std::list<std::pair<std::shared_ptr<SplIrBasicBlock>,
+                        std::shared_ptr<SplIrOperand>>>
+        incomings;
+    SplIrPhiInstruction(std::shared_ptr<SplIrOperand> dst)
+        : dst(dst), SplIrInstruction(SplIrInstructionType::PHI) {
+        if (!this->dst->is_l_value()) {
+            throw std::runtime_error("Phi instruction must have "
+                                     "l-value destination operand");
+        }
+        operands.push_front(this->dst);
+    }
+    void add_incoming(std::shared_ptr<SplIrBasicBlock> pred,
+                      std::shared_ptr<SplIrOperand> value) {
+        if (!value->is_value()) {
+            throw std::runtime_error(
+                "Phi instruction must have value incoming operand");
+        }
+        incomings.emplace_back(pred, value);
+        operands.push_front(incomings.back().second);
+    }
+    void print(std::stringstream &out) override;
+    std::shared_ptr<SplIrOperand> *def() override { return &dst; }
+    std::vector<std::shared_ptr<SplIrOperand> *> uses() override {
+        std::vector<std::shared_ptr<SplIrOperand> *> result;
+        for (auto &incoming : incomings) {
+            result.push_back(&incoming.second);
+        }
+        return result;
+    }
 };
 
 class SplIrBasicBlock {
@@ -635,6 +745,8 @@ class SplIrModule {
         }
     };
 
+    std::shared_ptr<SplIrAnalysisManager> analysis_manager;
+
     void build_use_list();
     void build_basic_blocks();
     void mark_head_instruction(SplIrInstructionList::iterator current);
@@ -646,6 +758,13 @@ class SplIrModule {
 
     std::unordered_map<std::string, SplIrInstructionList> use_lists;
     SplIrBasicBlockList basic_blocks;
+    // bumped whenever basic blocks are rebuilt, cached analyses on older
+    // basic blocks are stale
+    unsigned long basic_blocks_version = 0;
+    // set while phi instructions exist, each renamed operand is mapped to the
+    // operand it is renamed from
+    bool in_ssa_form = false;
+    std::unordered_map<std::string, std::shared_ptr<SplIrOperand>> ssa_origins;
 
     std::unique_ptr<SplIrAutoIncrementHelper> var_counter, tmp_counter,
         label_counter, bb_counter;
@@ -666,8 +785,26 @@ class SplIrModule {
                        std::shared_ptr<SplIrOperand> old_op,
                        std::shared_ptr<SplIrOperand> new_op);
     void erase_instruction(SplIrInstructionList::iterator it);
+    // insert inst before pos as a member of basic_block without rebuilding
+    // basic blocks, inst becomes the head if pos is the head
+    SplIrInstructionList::iterator
+    insert_instruction(SplIrInstructionList::iterator pos,
+                       std::shared_ptr<SplIrInstruction> inst,
+                       std::shared_ptr<SplIrBasicBlock> basic_block);
+    // erase the instruction without rebuilding basic blocks, fails if it is
+    // the only instruction of its basic block
+    bool erase_instruction_in_place(SplIrInstructionList::iterator it);
+    // replace the instruction by inst in the same basic block
+    void replace_instruction(SplIrInstructionList::iterator it,
+                             std::shared_ptr<SplIrInstruction> inst);
     void rebuild_basic_blocks();
+    void rebuild_use_lists();
+
+    // defined in spl-ir-analysis.hpp
+    SplIrAnalysisManager &analyses();
 
+    SplIrInstructionList::iterator
+    get_basic_block_end(std::shared_ptr<SplIrBasicBlock> basic_block);
     SplIrInstructionList::iterator
     get_ir_itor_by_inst(std::shared_ptr<SplIrInstruction> inst);
     SplIrInstructionList::iterator
@@ -710,6 +847,15 @@ class SplIrModule {
     }
 };
 
+void SplIrPhiInstruction::print(std::stringstream &out) {
+    out << dst->repr << " := PHI";
+    for (auto &incoming : incomings) {
+        out << " [" << incoming.second->repr << ", " << incoming.first->name
+            << "]";
+    }
+    out << std::endl;
+}
+
 void SplIrModule::build_use_list() {
     for (auto &inst : ir) {
         // std::cout << inst->operands.size() << std::endl;
@@ -766,6 +912,11 @@ void SplIrModule::build_basic_blocks() {
             }
             break;
         }
+        case SplIrInstructionType::PHI: {
+            // phi instructions sit at the head of a basic block marked by its
+            // label or by the jump before, and end no basic block
+            break;
+        }
         }
     }
     // patch parent for instructions
@@ -804,8 +955,22 @@ void SplIrModule::build_basic_blocks() {
             }
             break;
         }
+        case SplIrInstructionType::RETURN: {
+            break;
+        }
+        default: {
+            // fall through to the next basic block in the same function
+            auto next = it;
+            next++;
+            if (next != ir.end() && (*next)->parent != (*it)->parent &&
+                (*next)->type != SplIrInstructionType::FUNCTION) {
+                register_control_flow_edge(it, next);
+            }
+            break;
+        }
         }
     }
+    basic_blocks_version++;
     return;
 }
 
@@ -880,8 +1045,8 @@ void SplIrModule::replace_usage(std::shared_ptr<SplIrInstruction> inst,
         if (operand.get() == old_op) {
             operand.get() = new_op;
             // reduce use count for old_op, increase use count for new_op
-            auto old_use_list = use_lists[old_op->repr];
-            auto new_use_list = use_lists[new_op->repr];
+            auto &old_use_list = use_lists[old_op->repr];
+            auto &new_use_list = use_lists[new_op->repr];
             for (auto it = old_use_list.begin(); it != old_use_list.end();
                  it++) {
                 if (inst == *it) {
@@ -910,6 +1075,60 @@ void SplIrModule::erase_instruction(SplIrInstructionList::iterator it) {
     ir.erase(it);
 }
 
+SplIrInstructionList::iterator
+SplIrModule::insert_instruction(SplIrInstructionList::iterator pos,
+                                std::shared_ptr<SplIrInstruction> inst,
+                                std::shared_ptr<SplIrBasicBlock> basic_block) {
+    inst->parent = basic_block;
+    for (auto operand : inst->operands) {
+        use_lists[operand.get()->repr].push_back(inst);
+    }
+    auto it = ir.insert(pos, inst);
+    if (pos == basic_block->head) {
+        basic_block->head = it;
+    }
+    return it;
+}
+
+bool SplIrModule::erase_instruction_in_place(
+    SplIrInstructionList::iterator it) {
+    auto basic_block = (*it)->parent;
+    if (basic_block != nullptr && basic_block->head == it) {
+        auto next = std::next(it);
+        if (next == ir.end() || (*next)->parent != basic_block) {
+            return false;
+        }
+        basic_block->head = next;
+    }
+    erase_instruction(it);
+    return true;
+}
+
+void SplIrModule::replace_instruction(SplIrInstructionList::iterator it,
+                                      std::shared_ptr<SplIrInstruction> inst) {
+    for (auto operand : (*it)->operands) {
+        auto &use_list = use_lists[operand.get()->repr];
+        auto it_use = std::find(use_list.begin(), use_list.end(), *it);
+        if (it_use != use_list.end()) {
+            use_list.erase(it_use);
+        }
+    }
+    for (auto operand : inst->operands) {
+        use_lists[operand.get()->repr].push_back(inst);
+    }
+    inst->parent = (*it)->parent;
+    *it = inst;
+}
+
+SplIrInstructionList::iterator SplIrModule::get_basic_block_end(
+    std::shared_ptr<SplIrBasicBlock> basic_block) {
+    auto it = basic_block->head;
+    while (it != ir.end() && (*it)->parent == basic_block) {
+        it++;
+    }
+    return it;
+}
+
 SplIrInstructionList::iterator
 SplIrModule::get_ir_itor_by_inst(std::shared_ptr<SplIrInstruction> inst) {
     return std::find(ir.begin(), ir.end(), inst);
@@ -943,7 +1162,16 @@ SplIrModule::get_ir_itor_by_label_name(std::string label_name) {
     return ir.end();
 }
 
+void SplIrModule::rebuild_use_lists() {
+    use_lists.clear();
+    build_use_list();
+}
+
 void SplIrModule::rebuild_basic_blocks() {
+    if (in_ssa_form) {
+        throw std::runtime_error(
+            "Basic blocks must not be rebuilt while in ssa form");
+    }
     for (auto it = ir.begin(); it != ir.end(); it++) {
         (*it)->parent = nullptr;
     }
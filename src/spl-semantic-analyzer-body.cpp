@@ -627,6 +627,8 @@ void traverse(SplAstNode *current) {
                 }
                 auto &member =
                     static_cast<SplVariableSymbol &>(*it_member->second);
+                // used to lay out hot members first
+                sym_struct.access_counts[v_id.val_id]++;
                 current->attr.value =
                     std::make_unique<SplValExp>(member.var_type, true);
                 break;